@@ -21,6 +21,7 @@
 #include "AbilitySystem/AbilityAsync/KaosAbilityAsync_GameplayAbilityCooldown.h"
 
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/KaosScopedAbilitySpecView.h"
 
 UKaosAbilityAsync_GameplayAbilityCooldown* UKaosAbilityAsync_GameplayAbilityCooldown::WaitAbilityCooldown(AActor* TargetActor, FGameplayTag WithAbilityTag, FGameplayTag WithoutAbilityTag, bool OnlyTriggerOnce)
 {
@@ -99,8 +100,8 @@ void UKaosAbilityAsync_GameplayAbilityCooldown::Activate()
 		}
 		else //Search all activatable abilities.
 		{
-			//Make a copy, cause of ability scope locking issues.
-			TArray<FGameplayAbilitySpec> Specs = ASC->GetActivatableAbilities();
+			//Walk the live ability specs under the ability list lock.
+			FKaosScopedAbilitySpecView Specs(*ASC);
 			for (const FGameplayAbilitySpec& Spec : Specs)
 			{
 				if (Spec.Ability && Spec.Ability->AbilityTags.HasTag(CachedWithAbilityTag) && !Spec.Ability->AbilityTags.HasTag(CachedWithoutAbilityTag))
@@ -0,0 +1,84 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "AbilitySystem/KaosAbilityCooldowns.h"
+#include "AbilitySystem/KaosAbilitySystemComponent.h"
+
+void FKaosAbilityCooldownEntry::PostReplicatedAdd(const FKaosAbilityCooldownArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnTimestampCooldownReplicated(*this);
+	}
+}
+
+void FKaosAbilityCooldownEntry::PostReplicatedChange(const FKaosAbilityCooldownArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnTimestampCooldownReplicated(*this);
+	}
+}
+
+void FKaosAbilityCooldownEntry::PreReplicatedRemove(const FKaosAbilityCooldownArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnTimestampCooldownRemoved(Handle);
+	}
+}
+
+void FKaosAbilityCooldownArray::SetCooldown(const FGameplayAbilitySpecHandle& Handle, double EndServerTime, float Duration)
+{
+	FKaosAbilityCooldownEntry* Entry = Items.FindByPredicate([&Handle](const FKaosAbilityCooldownEntry& Item) { return Item.Handle == Handle; });
+	if (Entry == nullptr)
+	{
+		Entry = &Items.AddDefaulted_GetRef();
+		Entry->Handle = Handle;
+	}
+
+	Entry->EndServerTime = EndServerTime;
+	Entry->Duration = Duration;
+	MarkItemDirty(*Entry);
+}
+
+bool FKaosAbilityCooldownArray::RemoveCooldown(const FGameplayAbilitySpecHandle& Handle)
+{
+	const int32 NumRemoved = Items.RemoveAllSwap([&Handle](const FKaosAbilityCooldownEntry& Item) { return Item.Handle == Handle; });
+	if (NumRemoved > 0)
+	{
+		MarkArrayDirty();
+	}
+	return NumRemoved > 0;
+}
+
+void FKaosAbilityCooldownArray::RemoveExpired(double ServerTime)
+{
+	const int32 NumRemoved = Items.RemoveAllSwap([ServerTime](const FKaosAbilityCooldownEntry& Item) { return Item.EndServerTime <= ServerTime; });
+	if (NumRemoved > 0)
+	{
+		MarkArrayDirty();
+	}
+}
+
+const FKaosAbilityCooldownEntry* FKaosAbilityCooldownArray::FindCooldown(const FGameplayAbilitySpecHandle& Handle) const
+{
+	return Items.FindByPredicate([&Handle](const FKaosAbilityCooldownEntry& Item) { return Item.Handle == Handle; });
+}
@@ -0,0 +1,346 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "AbilitySystem/KaosAbilitySpecIndex.h"
+#include "Abilities/GameplayAbility.h"
+
+#if DO_CHECK
+static bool GKaosValidateAbilitySpecIndex = false;
+static FAutoConsoleVariableRef CVarKaosValidateAbilitySpecIndex(TEXT("AbilitySystem.Kaos.ValidateAbilitySpecIndex"), GKaosValidateAbilitySpecIndex,
+                                                                TEXT("Check the Kaos ability spec handle to slot map against the spec array on every lookup"));
+#endif
+
+FKaosResolvedAbilityTags::FKaosResolvedAbilityTags(const FGameplayTagContainer& InTags)
+	: Tags(InTags)
+{
+	TagHashes.Reserve(Tags.Num());
+	for (const FGameplayTag& Tag : Tags)
+	{
+		TagHashes.Add(GetTypeHash(Tag));
+
+		const int32 TagIndex = FKaosGameplayTagBitSet::GetTagIndex(Tag);
+		bAllTagsHaveBits &= TagIndex != INDEX_NONE;
+		TagBits.AddTagIndex(TagIndex);
+	}
+}
+
+void FKaosAbilitySpecIndex::AddSpec(const FGameplayAbilitySpec& Spec, int32 Slot)
+{
+	if (!Spec.Handle.IsValid())
+	{
+		return;
+	}
+
+	if (Slot != INDEX_NONE)
+	{
+		HandleToSlot.Add(Spec.Handle, Slot);
+	}
+	else
+	{
+		bSlotsStale = true;
+	}
+
+	if (Spec.Ability == nullptr || IndexedSpecs.Contains(Spec.Handle))
+	{
+		return;
+	}
+
+	FIndexedSpec& IndexedSpec = IndexedSpecs.Add(Spec.Handle);
+
+	// Index under every explicit tag and all of their parents, so a lookup for a parent tag finds child tagged abilities
+	FGameplayTagContainer ExpandedTags = Spec.Ability->AbilityTags.GetGameplayTagParents();
+	IndexedSpec.Tags.Reserve(ExpandedTags.Num());
+	for (const FGameplayTag& Tag : ExpandedTags)
+	{
+		TagToSpecHandles.FindOrAdd(Tag).Add(Spec.Handle);
+		IndexedSpec.Tags.Add(Tag);
+		IndexedSpec.TagBits.AddTag(Tag);
+	}
+
+	IndexedSpec.AbilityClass = FObjectKey(Spec.Ability->GetClass());
+	IndexedSpec.SourceObject = FObjectKey(Spec.SourceObject.Get());
+	ClassToSpecHandles.FindOrAdd(IndexedSpec.AbilityClass).Add(Spec.Handle);
+	ClassAndSourceToSpecHandles.FindOrAdd(FClassAndSourceKey(IndexedSpec.AbilityClass, IndexedSpec.SourceObject)).Add(Spec.Handle);
+
+	if (const FGameplayTagContainer* CooldownTags = Spec.Ability->GetCooldownTags())
+	{
+		IndexedSpec.CooldownTags.Reserve(CooldownTags->Num());
+		for (const FGameplayTag& Tag : *CooldownTags)
+		{
+			CooldownTagToSpecHandles.FindOrAdd(Tag).Add(Spec.Handle);
+			IndexedSpec.CooldownTags.Add(Tag);
+			if (ActiveCooldownTags.Contains(Tag))
+			{
+				++IndexedSpec.ActiveCooldownTagCount;
+			}
+		}
+	}
+
+	SpecHandles.Add(Spec.Handle);
+}
+
+void FKaosAbilitySpecIndex::RemoveSpec(const FGameplayAbilitySpecHandle& Handle)
+{
+	// The spec is still in the array at this point, the engine removes it (and swaps another into its slot) afterwards
+	if (HandleToSlot.Remove(Handle) > 0)
+	{
+		bSlotsStale = true;
+	}
+
+	FIndexedSpec IndexedSpec;
+	if (!IndexedSpecs.RemoveAndCopyValue(Handle, IndexedSpec))
+	{
+		return;
+	}
+
+	// RemoveSingle keeps grant order so lookups stay deterministic
+	for (const FGameplayTag& Tag : IndexedSpec.Tags)
+	{
+		if (TArray<FGameplayAbilitySpecHandle>* Handles = TagToSpecHandles.Find(Tag))
+		{
+			Handles->RemoveSingle(Handle);
+			if (Handles->IsEmpty())
+			{
+				TagToSpecHandles.Remove(Tag);
+			}
+		}
+	}
+
+	if (TArray<FGameplayAbilitySpecHandle>* Handles = ClassToSpecHandles.Find(IndexedSpec.AbilityClass))
+	{
+		Handles->RemoveSingle(Handle);
+		if (Handles->IsEmpty())
+		{
+			ClassToSpecHandles.Remove(IndexedSpec.AbilityClass);
+		}
+	}
+
+	const FClassAndSourceKey ClassAndSource(IndexedSpec.AbilityClass, IndexedSpec.SourceObject);
+	if (TArray<FGameplayAbilitySpecHandle>* Handles = ClassAndSourceToSpecHandles.Find(ClassAndSource))
+	{
+		Handles->RemoveSingle(Handle);
+		if (Handles->IsEmpty())
+		{
+			ClassAndSourceToSpecHandles.Remove(ClassAndSource);
+		}
+	}
+
+	for (const FGameplayTag& Tag : IndexedSpec.CooldownTags)
+	{
+		if (TArray<FGameplayAbilitySpecHandle>* Handles = CooldownTagToSpecHandles.Find(Tag))
+		{
+			Handles->RemoveSingle(Handle);
+			if (Handles->IsEmpty())
+			{
+				CooldownTagToSpecHandles.Remove(Tag);
+			}
+		}
+	}
+
+	SpecHandles.RemoveSingle(Handle);
+}
+
+FGameplayAbilitySpecHandle FKaosAbilitySpecIndex::FindHandleByClass(const TArray<FGameplayAbilitySpec>& Specs, const UClass* AbilityClass) const
+{
+	return FindFirstHandleInSlotOrder(Specs, ClassToSpecHandles.Find(FObjectKey(AbilityClass)));
+}
+
+FGameplayAbilitySpecHandle FKaosAbilitySpecIndex::FindHandleByClassAndSource(const TArray<FGameplayAbilitySpec>& Specs, const UClass* AbilityClass, const UObject* SourceObject) const
+{
+	return FindFirstHandleInSlotOrder(Specs, ClassAndSourceToSpecHandles.Find(FClassAndSourceKey(FObjectKey(AbilityClass), FObjectKey(SourceObject))));
+}
+
+FGameplayAbilitySpecHandle FKaosAbilitySpecIndex::FindFirstHandleInSlotOrder(const TArray<FGameplayAbilitySpec>& Specs, const TArray<FGameplayAbilitySpecHandle>* Handles) const
+{
+	if (!Handles)
+	{
+		return FGameplayAbilitySpecHandle();
+	}
+
+	// The same class is rarely granted more than once, only pay for slot lookups when it is
+	if (Handles->Num() == 1)
+	{
+		return (*Handles)[0];
+	}
+
+	FGameplayAbilitySpecHandle FirstHandle;
+	int32 FirstSlot = MAX_int32;
+	for (const FGameplayAbilitySpecHandle& Handle : *Handles)
+	{
+		const int32 Slot = GetSlot(Specs, Handle);
+		if (!FirstHandle.IsValid() || Slot < FirstSlot)
+		{
+			FirstHandle = Handle;
+			FirstSlot = Slot;
+		}
+	}
+	return FirstHandle;
+}
+
+int32 FKaosAbilitySpecIndex::GetSlot(const TArray<FGameplayAbilitySpec>& Specs, const FGameplayAbilitySpecHandle& Handle) const
+{
+	if (bSlotsStale)
+	{
+		RebuildSlots(Specs);
+	}
+
+	const int32* Slot = HandleToSlot.Find(Handle);
+	return Slot ? *Slot : MAX_int32;
+}
+
+bool FKaosAbilitySpecIndex::IsOnCooldown(const FGameplayAbilitySpecHandle& Handle) const
+{
+	const FIndexedSpec* IndexedSpec = IndexedSpecs.Find(Handle);
+	return IndexedSpec && IndexedSpec->ActiveCooldownTagCount > 0;
+}
+
+const TArray<FGameplayTag>* FKaosAbilitySpecIndex::GetCooldownTags(const FGameplayAbilitySpecHandle& Handle) const
+{
+	const FIndexedSpec* IndexedSpec = IndexedSpecs.Find(Handle);
+	return IndexedSpec ? &IndexedSpec->CooldownTags : nullptr;
+}
+
+const FKaosGameplayTagBitSet* FKaosAbilitySpecIndex::GetAbilityTagBits(const FGameplayAbilitySpecHandle& Handle) const
+{
+	const FIndexedSpec* IndexedSpec = IndexedSpecs.Find(Handle);
+	return IndexedSpec ? &IndexedSpec->TagBits : nullptr;
+}
+
+void FKaosAbilitySpecIndex::RebuildTagBits()
+{
+	for (TPair<FGameplayAbilitySpecHandle, FIndexedSpec>& Pair : IndexedSpecs)
+	{
+		FIndexedSpec& IndexedSpec = Pair.Value;
+		IndexedSpec.TagBits.Reset();
+		for (const FGameplayTag& Tag : IndexedSpec.Tags)
+		{
+			IndexedSpec.TagBits.AddTag(Tag);
+		}
+	}
+}
+
+bool FKaosAbilitySpecIndex::SetCooldownTagActive(const FGameplayTag& Tag, bool bActive)
+{
+	if (bActive)
+	{
+		bool bAlreadyActive = false;
+		ActiveCooldownTags.Add(Tag, &bAlreadyActive);
+		if (bAlreadyActive)
+		{
+			return false;
+		}
+	}
+	else if (ActiveCooldownTags.Remove(Tag) == 0)
+	{
+		return false;
+	}
+
+	if (const TArray<FGameplayAbilitySpecHandle>* Handles = CooldownTagToSpecHandles.Find(Tag))
+	{
+		for (const FGameplayAbilitySpecHandle& Handle : *Handles)
+		{
+			FIndexedSpec& IndexedSpec = IndexedSpecs.FindChecked(Handle);
+			IndexedSpec.ActiveCooldownTagCount += bActive ? 1 : -1;
+			check(IndexedSpec.ActiveCooldownTagCount >= 0);
+		}
+	}
+	return true;
+}
+
+void FKaosAbilitySpecIndex::Reset()
+{
+	TagToSpecHandles.Reset();
+	ClassToSpecHandles.Reset();
+	ClassAndSourceToSpecHandles.Reset();
+	CooldownTagToSpecHandles.Reset();
+	IndexedSpecs.Reset();
+	SpecHandles.Reset();
+	HandleToSlot.Reset();
+	bSlotsStale = false;
+}
+
+FGameplayAbilitySpec* FKaosAbilitySpecIndex::FindSpec(TArray<FGameplayAbilitySpec>& Specs, const FGameplayAbilitySpecHandle& Handle)
+{
+	if (!Handle.IsValid())
+	{
+		return nullptr;
+	}
+
+	if (bSlotsStale)
+	{
+		RebuildSlots(Specs);
+	}
+
+#if DO_CHECK
+	if (GKaosValidateAbilitySpecIndex)
+	{
+		CheckSlotConsistency(Specs);
+	}
+#endif
+
+	const int32* Slot = HandleToSlot.Find(Handle);
+	if (Slot && Specs.IsValidIndex(*Slot) && Specs[*Slot].Handle == Handle)
+	{
+		return &Specs[*Slot];
+	}
+
+	// A mapped slot that no longer holds the handle is only reachable if the array was changed without going through the
+	// give/remove hooks. An unmapped handle is simply not granted, AddSpec maps every spec so that is never a reason to
+	// rebuild.
+	if (Slot)
+	{
+		RebuildSlots(Specs);
+		Slot = HandleToSlot.Find(Handle);
+		return Slot ? &Specs[*Slot] : nullptr;
+	}
+
+	return nullptr;
+}
+
+void FKaosAbilitySpecIndex::RebuildSlots(const TArray<FGameplayAbilitySpec>& Specs) const
+{
+	HandleToSlot.Reset();
+	for (int32 Slot = 0; Slot < Specs.Num(); ++Slot)
+	{
+		if (Specs[Slot].Handle.IsValid())
+		{
+			HandleToSlot.Add(Specs[Slot].Handle, Slot);
+		}
+	}
+	bSlotsStale = false;
+}
+
+#if DO_CHECK
+void FKaosAbilitySpecIndex::CheckSlotConsistency(const TArray<FGameplayAbilitySpec>& Specs) const
+{
+	if (bSlotsStale)
+	{
+		return;
+	}
+
+	checkf(HandleToSlot.Num() == Specs.Num(), TEXT("Kaos ability spec index maps %d handles but there are %d specs"), HandleToSlot.Num(), Specs.Num());
+	for (int32 Slot = 0; Slot < Specs.Num(); ++Slot)
+	{
+		const int32* MappedSlot = HandleToSlot.Find(Specs[Slot].Handle);
+		checkf(MappedSlot && *MappedSlot == Slot, TEXT("Kaos ability spec index has spec %s at slot %d but the array has it at %d"),
+		       *Specs[Slot].Handle.ToString(), MappedSlot ? *MappedSlot : INDEX_NONE, Slot);
+	}
+}
+#endif
@@ -22,21 +22,148 @@
 #include "KaosUtilitiesLogging.h"
 #include "AbilitySystem/KaosAbilityTagRelationships.h"
 #include "AbilitySystem/KaosGameplayAbility.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/Pawn.h"
+#include "GameplayEffect.h"
+#include "GameplayTagsManager.h"
+#include "GameplayTagsModule.h"
+#include "TimerManager.h"
+#include "Misc/ScopeRWLock.h"
+#include "Net/UnrealNetwork.h"
+#include "UObject/ObjectKey.h"
+#include "KaosUtilitiesStats.h"
+
+namespace KaosAbilitySystemComponent_Impl
+{
+	/** Indices of the additive modifiers of a gameplay effect definition */
+	struct FAdditiveModifierIndices
+	{
+		int32 NumModifiers = INDEX_NONE;
+		TArray<int32, TInlineAllocator<4>> Indices;
+	};
+
+	/**
+	 * Additive modifier indices per gameplay effect definition, guarded by AdditiveModifierIndicesLock. Entries of
+	 * collected definitions are purged after every garbage collection.
+	 */
+	static TMap<FObjectKey, FAdditiveModifierIndices> AdditiveModifierIndicesCache;
+	static FRWLock AdditiveModifierIndicesLock;
+
+	/** Drops the entries of definitions that have been garbage collected, so the cache only holds live effects */
+	static void PurgeCollectedAdditiveModifierIndices()
+	{
+		FWriteScopeLock WriteLock(AdditiveModifierIndicesLock);
+		for (auto It = AdditiveModifierIndicesCache.CreateIterator(); It; ++It)
+		{
+			if (It.Key().ResolveObjectPtr() == nullptr)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	static FAdditiveModifierIndices GetAdditiveModifierIndices(const UGameplayEffect& Def)
+	{
+		static FDelegateHandle PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&PurgeCollectedAdditiveModifierIndices);
+
+#if WITH_EDITOR
+		// Modifiers edited in place keep the definition pointer, so start over whenever an effect is edited
+		static FDelegateHandle ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda([](UObject* Object, FPropertyChangedEvent&)
+		{
+			if (Object && Object->IsA<UGameplayEffect>())
+			{
+				FWriteScopeLock WriteLock(AdditiveModifierIndicesLock);
+				AdditiveModifierIndicesCache.Reset();
+			}
+		});
+#endif
+
+		{
+			FReadScopeLock ReadLock(AdditiveModifierIndicesLock);
+			const FAdditiveModifierIndices* Cached = AdditiveModifierIndicesCache.Find(FObjectKey(&Def));
+			if (Cached && Cached->NumModifiers == Def.Modifiers.Num())
+			{
+				return *Cached;
+			}
+		}
+
+		FAdditiveModifierIndices Entry;
+		Entry.NumModifiers = Def.Modifiers.Num();
+		for (int32 ModIdx = 0; ModIdx < Def.Modifiers.Num(); ++ModIdx)
+		{
+			// It only makes sense to check additive operators
+			if (Def.Modifiers[ModIdx].ModifierOp == EGameplayModOp::Additive && Def.Modifiers[ModIdx].Attribute.IsValid())
+			{
+				Entry.Indices.Add(ModIdx);
+			}
+		}
+
+		FWriteScopeLock WriteLock(AdditiveModifierIndicesLock);
+		AdditiveModifierIndicesCache.Add(FObjectKey(&Def), Entry);
+		return Entry;
+	}
+}
+
+UKaosAbilitySystemComponent::UKaosAbilitySystemComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	TimestampCooldowns.Owner = this;
+}
+
+void UKaosAbilitySystemComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(UKaosAbilitySystemComponent, TimestampCooldowns, COND_ReplayOrOwner);
+}
 
 void UKaosAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags,
                                                                  const FGameplayTagContainer& CancelTags)
 {
+	KAOS_GAS_SCOPE(TagRelationships);
+
 	FGameplayTagContainer AbilityBlockTags = BlockTags;
-	FGameplayTagContainer AbilityCancelTags = CancelTags;
+	FKaosGameplayTagBitSet AbilityCancelTagBits;
+	if (bExecuteCancelTags)
+	{
+		AbilityCancelTagBits = FKaosGameplayTagBitSet::FromContainer(CancelTags);
+	}
 
 	const UKaosAbilityTagRelationships* TagRelationship = GetAbilityTagRelationships();
 	if (TagRelationship)
 	{
-		TagRelationship->GetAbilityTagsToBlockAndCancel(AbilityTags, &AbilityBlockTags, &AbilityCancelTags);
+		TagRelationship->GetAbilityTagsToBlockAndCancelBits(AbilityTags, &AbilityBlockTags, bExecuteCancelTags ? &AbilityCancelTagBits : nullptr);
 	}
 
-	Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, AbilityBlockTags, bExecuteCancelTags, AbilityCancelTags);
+	// Same as the base implementation, with cancel matching done against the indexed ability tag bits
+	if (bEnableBlockTags)
+	{
+		BlockAbilitiesWithTags(AbilityBlockTags);
+	}
+	else
+	{
+		UnBlockAbilitiesWithTags(AbilityBlockTags);
+	}
+
+	if (bExecuteCancelTags && !AbilityCancelTagBits.IsEmpty())
+	{
+		ABILITYLIST_SCOPE_LOCK();
+		for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+		{
+			if (!Spec.IsActive() || Spec.Ability == nullptr)
+			{
+				continue;
+			}
+
+			// Index bits include parent tags, so this matches AbilityTags.HasAny(CancelTags)
+			const FKaosGameplayTagBitSet* AbilityTagBits = AbilitySpecIndex.GetAbilityTagBits(Spec.Handle);
+			const bool bCancel = AbilityTagBits ? AbilityTagBits->HasAny(AbilityCancelTagBits) : FKaosGameplayTagBitSet::FromContainer(Spec.Ability->AbilityTags, true).HasAny(AbilityCancelTagBits);
+			if (bCancel)
+			{
+				CancelAbilitySpec(Spec, RequestingAbility);
+			}
+		}
+	}
 }
 
 void UKaosAbilitySystemComponent::K2_UnBlockAbilitiesWithTags(FGameplayTagContainer& Tags)
@@ -51,6 +178,8 @@ void UKaosAbilitySystemComponent::K2_BlockAbilitiesWithTags(FGameplayTagContaine
 
 void UKaosAbilitySystemComponent::GetRelationshipActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const
 {
+	KAOS_GAS_SCOPE(TagRelationships);
+
 	const UKaosAbilityTagRelationships* TagRelationship = GetAbilityTagRelationships();
 	if (TagRelationship)
 	{
@@ -58,13 +187,54 @@ void UKaosAbilitySystemComponent::GetRelationshipActivationTagRequirements(const
 	}
 }
 
+bool UKaosAbilitySystemComponent::UsesOwnedTagBits() const
+{
+	const UClass* NativeClass = GetClass();
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+	return NativeClass == UKaosAbilitySystemComponent::StaticClass();
+}
+
+void UKaosAbilitySystemComponent::VisitRelationshipActivationTagBits(const FGameplayTagContainer& AbilityTags, TFunctionRef<void(const FKaosGameplayTagBitSet& RequiredTagBits, const FKaosGameplayTagBitSet& BlockedTagBits)> Func) const
+{
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	const UKaosAbilityTagRelationships* TagRelationship = GetAbilityTagRelationships();
+	if (TagRelationship)
+	{
+		TagRelationship->VisitActivationTagBits(AbilityTags, Func);
+	}
+}
+
 void UKaosAbilitySystemComponent::NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
 {
 	if (const APawn* Avatar = Cast<APawn>(GetAvatarActor()))
 	{
 		if (!Avatar->IsLocallyControlled() && Ability->IsSupportedForNetworking())
 		{
-			ClientNotifyAbilityFailed(Ability, FailureReason);
+			FKaosAbilityFailure Failure;
+			Failure.Handle = Handle;
+			for (const FGameplayTag& Tag : FailureReason)
+			{
+				const int32 NetIndex = FKaosGameplayTagBitSet::GetTagIndex(Tag);
+				if (NetIndex != INDEX_NONE)
+				{
+					Failure.FailureTagNetIndices.Add(static_cast<uint16>(NetIndex));
+				}
+			}
+			Failure.FailureTagNetIndices.Sort();
+
+			// Input spam fails the same way many times a frame, the client only needs to hear about it once
+			if (!PendingAbilityFailures.Contains(Failure))
+			{
+				if (PendingAbilityFailures.IsEmpty())
+				{
+					GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UKaosAbilitySystemComponent::FlushAbilityFailures);
+				}
+				PendingAbilityFailures.Add(MoveTemp(Failure));
+			}
 			return;
 		}
 	}
@@ -72,18 +242,29 @@ void UKaosAbilitySystemComponent::NotifyAbilityFailed(const FGameplayAbilitySpec
 	HandleAbilityFailed(Ability, FailureReason);
 }
 
+void UKaosAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
+{
+	Super::NotifyAbilityActivated(Handle, Ability);
+
+	UpdateActiveAbilityTags(Handle, Ability, true);
+	InvalidateCanActivateAbilityCache();
+}
+
 void UKaosAbilitySystemComponent::NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled)
 {
 	Super::NotifyAbilityEnded(Handle, Ability, bWasCancelled);
 
-	FGameplayAbilitySpec* Spec = FindAbilitySpecFromHandle(Handle);
+	UpdateActiveAbilityTags(Handle, Ability, false);
+	InvalidateCanActivateAbilityCache();
+
+	FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handle);
 	ENetRole OwnerRole = GetOwnerRole();
 	UKaosGameplayAbility* KaosGA = Cast<UKaosGameplayAbility>(Ability);
-	if (OwnerRole == ROLE_Authority && !Spec->RemoveAfterActivation)
+	if (OwnerRole == ROLE_Authority && Spec && !Spec->RemoveAfterActivation)
 	{
 		if (KaosGA && KaosGA->IsInstantiated() && KaosGA->ShouldRemoveAfterActivation() && !Spec->IsActive())
 		{
-			ClearAbility(Handle);
+			QueueAbilityRemoval(Handle);
 		}
 	}
 }
@@ -100,28 +281,40 @@ TArray<FActiveGameplayEffectHandle> UKaosAbilitySystemComponent::GetAllActiveEff
 
 bool UKaosAbilitySystemComponent::CanApplyAttributeModifiers(FGameplayEffectSpec EffectSpec)
 {
-	EffectSpec.CalculateModifierMagnitudes();
+	return CanApplyEffectSpecModifiers(EffectSpec);
+}
+
+bool UKaosAbilitySystemComponent::CanApplyEffectSpecModifiers(const FGameplayEffectSpec& EffectSpec) const
+{
+	return CanAbilitySystemApplyAttributeModifiers(*this, EffectSpec);
+}
+
+bool UKaosAbilitySystemComponent::CanAbilitySystemApplyAttributeModifiers(const UAbilitySystemComponent& AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec)
+{
+	if (EffectSpec.Def == nullptr)
+	{
+		return true;
+	}
+
+	const UGameplayEffect& Def = *EffectSpec.Def;
 
-	for (int32 ModIdx = 0; ModIdx < EffectSpec.Modifiers.Num(); ++ModIdx)
+	for (const int32 ModIdx : KaosAbilitySystemComponent_Impl::GetAdditiveModifierIndices(Def).Indices)
 	{
-		const FGameplayModifierInfo& ModDef = EffectSpec.Def->Modifiers[ModIdx];
-		const FModifierSpec& ModSpec = EffectSpec.Modifiers[ModIdx];
+		const FGameplayModifierInfo& ModDef = Def.Modifiers[ModIdx];
 
-		// It only makes sense to check additive operators
-		if (ModDef.ModifierOp == EGameplayModOp::Additive)
+		// Same evaluation FGameplayEffectSpec::CalculateModifierMagnitudes does, without touching the spec
+		float CostValue = 0.f;
+		if (!ModDef.ModifierMagnitude.AttemptCalculateMagnitude(EffectSpec, CostValue))
 		{
-			if (!ModDef.Attribute.IsValid())
-			{
-				continue;
-			}
-			const UAttributeSet* Set = GetAttributeSubobject(ModDef.Attribute.GetAttributeSetClass());
-			const float CurrentValue = ModDef.Attribute.GetNumericValueChecked(Set);
-			const float CostValue = ModSpec.GetEvaluatedMagnitude();
+			CostValue = 0.f;
+		}
 
-			if (CurrentValue + CostValue < 0.f)
-			{
-				return false;
-			}
+		const UAttributeSet* Set = AbilitySystemComponent.GetAttributeSet(ModDef.Attribute.GetAttributeSetClass());
+		const float CurrentValue = ModDef.Attribute.GetNumericValueChecked(Set);
+
+		if (CurrentValue + CostValue < 0.f)
+		{
+			return false;
 		}
 	}
 	return true;
@@ -154,307 +347,1194 @@ const UKaosAbilityTagRelationships* UKaosAbilitySystemComponent::GetAbilityTagRe
 	return AbilityTagRelationship;
 }
 
-void UKaosAbilitySystemComponent::ClientNotifyAbilityFailed_Implementation(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
+void UKaosAbilitySystemComponent::QueueAbilityRemoval(const FGameplayAbilitySpecHandle& Handle)
 {
-	HandleAbilityFailed(Ability, FailureReason);
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		// Nothing to batch on, clear it the way the engine would have
+		ClearAbility(Handle);
+		return;
+	}
+
+	// Stop the spec from being activated again before the flush, as if it had been cleared right away
+	if (FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handle))
+	{
+		Spec->PendingRemove = true;
+	}
+
+	if (PendingAbilityRemovals.IsEmpty())
+	{
+		World->GetTimerManager().SetTimerForNextTick(this, &UKaosAbilitySystemComponent::FlushPendingAbilityRemovals);
+	}
+	PendingAbilityRemovals.AddUnique(Handle);
 }
 
-void UKaosAbilitySystemComponent::HandleAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
+void UKaosAbilitySystemComponent::FlushPendingAbilityRemovals()
 {
-	if (const UKaosGameplayAbility* KaosAbility = Cast<const UKaosGameplayAbility>(Ability))
+	TArray<FGameplayAbilitySpecHandle> Handles = MoveTemp(PendingAbilityRemovals);
+	PendingAbilityRemovals.Reset();
+
+	if (Handles.IsEmpty() || !IsOwnerActorAuthoritative())
 	{
-		KaosAbility->OnAbilityFailedToActivate(FailureReason);
-		if (KaosAbility->IsPassiveAbility())
+		return;
+	}
+
+	// An activation that got in before the spec was queued may still be running, it is queued again when it ends
+	for (int32 Idx = Handles.Num() - 1; Idx >= 0; --Idx)
+	{
+		const FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handles[Idx]);
+		if (Spec && Spec->IsActive())
 		{
-			KaosAbility->NotifyFailedToActivatePassiveAbility();
+			Handles.RemoveAtSwap(Idx);
 		}
 	}
-}
 
-bool UKaosAbilitySystemComponent::CanActivateAbilityByHandle(const FGameplayAbilitySpecHandle& Handle, FGameplayTagContainer& OutFailureTags)
-{
-	ABILITYLIST_SCOPE_LOCK();
-	for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+	// Removing from the array now would break whoever holds the lock, ClearAbility defers them instead. It only defers
+	// specs that aren't pending remove yet, so hand them back in the state it expects.
+	if (AbilityScopeLockCount > 0)
 	{
-		const FGameplayAbilityActorInfo* ActorInfo = AbilityActorInfo.Get();
-		
-		if (AbilitySpec.Handle == Handle && AbilitySpec.Ability)
+		for (const FGameplayAbilitySpecHandle& Handle : Handles)
 		{
-			return AbilitySpec.Ability->CanActivateAbility(AbilitySpec.Handle, ActorInfo, nullptr, nullptr, &OutFailureTags);
+			if (FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handle))
+			{
+				Spec->PendingRemove = false;
+			}
+			ClearAbility(Handle);
 		}
+		return;
 	}
-	return false;
-}
 
-bool UKaosAbilitySystemComponent::CanActivateAbilityByClass(TSubclassOf<UGameplayAbility> AbilityClass, FGameplayTagContainer& OutFailureTags)
-{
-	ABILITYLIST_SCOPE_LOCK();
-	for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+	// Same steps as ClearAbility, once for the whole batch. Queued handles come from NotifyAbilityEnded on specs already
+	// in ActivatableAbilities and the list is not locked here, so none of them can be sitting in AbilityPendingAdds.
 	{
-		const FGameplayAbilityActorInfo* ActorInfo = AbilityActorInfo.Get();
-		const UGameplayAbility* Ability = AbilitySpec.GetPrimaryInstance() ? AbilitySpec.GetPrimaryInstance() : AbilitySpec.Ability.Get();
-		if (Ability->GetClass() == AbilityClass)
+		ABILITYLIST_SCOPE_LOCK();
+
+		for (int32 Idx = Handles.Num() - 1; Idx >= 0; --Idx)
 		{
-			return Ability->CanActivateAbility(AbilitySpec.Handle, ActorInfo, nullptr, nullptr, &OutFailureTags);
+			FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handles[Idx]);
+			if (Spec)
+			{
+				OnRemoveAbility(*Spec);
+			}
+			else
+			{
+				// Already cleared some other way
+				Handles.RemoveAtSwap(Idx);
+			}
 		}
 	}
-	return false;
+
+	if (Handles.IsEmpty())
+	{
+		return;
+	}
+
+	const TSet<FGameplayAbilitySpecHandle> HandleSet(Handles);
+	ActivatableAbilities.Items.RemoveAllSwap([&HandleSet](const FGameplayAbilitySpec& Spec)
+	{
+		return HandleSet.Contains(Spec.Handle);
+	});
+	ActivatableAbilities.MarkArrayDirty();
+	CheckForClearedAbilities();
 }
 
-bool UKaosAbilitySystemComponent::HasAttributeSet(TSubclassOf<UAttributeSet> AttributeClass) const
+void UKaosAbilitySystemComponent::FlushAbilityFailures()
 {
-	for (const UAttributeSet* Set : GetSpawnedAttributes())
+	if (PendingAbilityFailures.Num() > 0)
 	{
-		if (Set && Set->IsA(AttributeClass))
-		{
-			return true;
-		}
+		ClientNotifyAbilitiesFailed(PendingAbilityFailures);
+		PendingAbilityFailures.Reset();
 	}
-	return false;
 }
 
-bool UKaosAbilitySystemComponent::IsAbilityTagBlocked(FGameplayTag AbilityTag)
+void UKaosAbilitySystemComponent::ClientNotifyAbilityFailed_Implementation(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
 {
-	return AreAbilityTagsBlocked(FGameplayTagContainer(AbilityTag));
+	// Same handling as each entry of ClientNotifyAbilitiesFailed
+	HandleAbilityFailed(Ability, FailureReason);
 }
 
-
-void UKaosAbilitySystemComponent::CancelAbilityWithAllTags(const FGameplayTagContainer GameplayAbilityTags)
+void UKaosAbilitySystemComponent::ClientNotifyAbilitiesFailed_Implementation(const TArray<FKaosAbilityFailure>& Failures)
 {
-	ABILITYLIST_SCOPE_LOCK();
-	
-	for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+
+	for (const FKaosAbilityFailure& Failure : Failures)
 	{
-		//If ability cdo is null, we skip.
-		if (AbilitySpec.Ability == nullptr)
+		const FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Failure.Handle);
+		if (Spec == nullptr || Spec->Ability == nullptr)
 		{
 			continue;
 		}
 
-		//If tags match, cancel the ability
-		if (AbilitySpec.Ability->AbilityTags.HasAll(GameplayAbilityTags) && AbilitySpec.IsActive())
+		FGameplayTagContainer FailureReason;
+		for (const uint16 NetIndex : Failure.FailureTagNetIndices)
 		{
-			CancelAbilityHandle(AbilitySpec.Handle);
+			const FGameplayTag Tag = TagsManager.GetTagFromNetIndex(NetIndex);
+			if (Tag.IsValid())
+			{
+				FailureReason.AddTagFast(Tag);
+			}
 		}
+
+		const UGameplayAbility* Ability = Spec->GetPrimaryInstance() ? Spec->GetPrimaryInstance() : Spec->Ability.Get();
+		HandleAbilityFailed(Ability, FailureReason);
 	}
 }
 
-bool UKaosAbilitySystemComponent::IsAbilityOnCooldownWithAllTags(const FGameplayTagContainer GameplayAbilityTags)
+void UKaosAbilitySystemComponent::HandleAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
 {
-	ABILITYLIST_SCOPE_LOCK();
-	
-	for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+	if (const UKaosGameplayAbility* KaosAbility = Cast<const UKaosGameplayAbility>(Ability))
 	{
-		//If ability cdo is null, we skip.
-		if (AbilitySpec.Ability == nullptr)
-		{
-			continue;
-		}
-
-		//If tags match, check if the cooldown tags are applied to the ASC.
-		if (AbilitySpec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
+		KaosAbility->OnAbilityFailedToActivate(FailureReason);
+		if (KaosAbility->IsPassiveAbility())
 		{
-			const FGameplayTagContainer* CooldownTags = AbilitySpec.Ability->GetCooldownTags();
-			if (CooldownTags && CooldownTags->Num() > 0 && HasAnyMatchingGameplayTags(*CooldownTags))
-			{
-				return true;
-			}
+			KaosAbility->NotifyFailedToActivatePassiveAbility();
 		}
 	}
-	return false;
 }
 
-bool UKaosAbilitySystemComponent::HasAbilityWithAllTags(const FGameplayTagContainer GameplayAbilityTags)
+bool UKaosAbilitySystemComponent::CanActivateAbilityByHandle(const FGameplayAbilitySpecHandle& Handle, FGameplayTagContainer& OutFailureTags)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	ABILITYLIST_SCOPE_LOCK();
-	for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+	const FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(Handle);
+	if (AbilitySpec && AbilitySpec->Ability)
 	{
-		//If ability cdo is null, we skip.
-		if (AbilitySpec.Ability == nullptr)
-		{
-			continue;
-		}
-
-		//If tags match then we have the ability
-		if (AbilitySpec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
-		{
-			return true;
-		}
+		return CheckCanActivateAbility(*AbilitySpec, AbilitySpec->Ability, &OutFailureTags);
 	}
 	return false;
 }
 
-bool UKaosAbilitySystemComponent::CanActivateAbilityWithAllMatchingTags(const FGameplayTagContainer GameplayAbilityTags, FGameplayTagContainer& OutFailureTags)
+bool UKaosAbilitySystemComponent::CanActivateAbilityByClass(TSubclassOf<UGameplayAbility> AbilityClass, FGameplayTagContainer& OutFailureTags)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	ABILITYLIST_SCOPE_LOCK();
-	const FGameplayAbilityActorInfo* ActorInfo = AbilityActorInfo.Get();
-	//Loop through all specs and find if we can activate any ability
-	for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	const FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(AbilitySpecIndex.FindHandleByClass(ActivatableAbilities.Items, AbilityClass));
+	if (AbilitySpec)
 	{
-		//If ability cdo is null, we skip.
-		if (Spec.Ability == nullptr)
-		{
-			continue;
-		}
-
-		//If tags match and we can activate, return the call to CanActivateAbility.
-		if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
+		const UGameplayAbility* Ability = AbilitySpec->GetPrimaryInstance() ? AbilitySpec->GetPrimaryInstance() : AbilitySpec->Ability.Get();
+		if (Ability)
 		{
-			return Spec.Ability->CanActivateAbility(Spec.Handle, ActorInfo, nullptr, nullptr, &OutFailureTags);
+			return CheckCanActivateAbility(*AbilitySpec, Ability, &OutFailureTags);
 		}
 	}
 	return false;
 }
 
-
-
-bool UKaosAbilitySystemComponent::IsAbilityActive(const FGameplayAbilitySpecHandle& InHandle)
+bool UKaosAbilitySystemComponent::HasAttributeSet(TSubclassOf<UAttributeSet> AttributeClass) const
 {
-	ABILITYLIST_SCOPE_LOCK();
-	const FGameplayAbilitySpec* Spec = FindAbilitySpecFromHandle(InHandle);
-	return Spec ? Spec->IsActive() : false;
+	if (AttributeClass == nullptr)
+	{
+		return false;
+	}
+
+	if (GetSpawnedAttributes().Num() != NumCountedAttributeSets)
+	{
+		RebuildAttributeSetClasses();
+	}
+	return AttributeSetClassCounts.Contains(FObjectKey(AttributeClass.Get()));
 }
 
-FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindAbilitySpecFromTag(FGameplayTag Tag)
+void UKaosAbilitySystemComponent::AddAttributeSet(UAttributeSet* Attribute)
 {
-	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	const int32 NumSets = GetSpawnedAttributes().Num();
+	AddSpawnedAttribute(Attribute);
+	if (GetSpawnedAttributes().Num() != NumSets)
 	{
-		if (Spec.Ability->AbilityTags.HasTagExact(Tag))
-		{
-			return &Spec;
-		}
+		CountAttributeSetClasses(Attribute, 1);
 	}
-
-	return nullptr;
 }
 
-FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindAbilitySpecByClassAndSource(TSubclassOf<UGameplayAbility> AbilityClass, UObject* SourceObject)
+void UKaosAbilitySystemComponent::RemoveAttributeSet(UAttributeSet* Attribute)
 {
-	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	const int32 NumSets = GetSpawnedAttributes().Num();
+	RemoveSpawnedAttribute(Attribute);
+	if (GetSpawnedAttributes().Num() != NumSets)
 	{
-		if (Spec.Ability->GetClass() == AbilityClass && Spec.SourceObject == SourceObject)
-		{
-			return &Spec;
-		}
+		CountAttributeSetClasses(Attribute, -1);
 	}
-	return nullptr;
 }
 
-
-bool UKaosAbilitySystemComponent::IsAbilityActiveByClass(TSubclassOf<UGameplayAbility> AbilityClass, UObject* SourceObject)
+void UKaosAbilitySystemComponent::OnRep_SpawnedAttributes(const TArray<UAttributeSet*>& PreviousSpawnedAttributes)
 {
-	ABILITYLIST_SCOPE_LOCK();
+	Super::OnRep_SpawnedAttributes(PreviousSpawnedAttributes);
 
-	FGameplayAbilitySpec* Spec;
+	RebuildAttributeSetClasses();
+}
 
-	if (SourceObject)
-	{
-		Spec = FindAbilitySpecByClassAndSource(AbilityClass, SourceObject);
-	}
-	else
+void UKaosAbilitySystemComponent::CountAttributeSetClasses(const UAttributeSet* Set, int32 Delta) const
+{
+	NumCountedAttributeSets += Delta;
+	for (const UClass* Class = Set ? Set->GetClass() : nullptr; Class && Class->IsChildOf(UAttributeSet::StaticClass()); Class = Class->GetSuperClass())
 	{
-		Spec = FindAbilitySpecFromClass(AbilityClass);
+		int32& Count = AttributeSetClassCounts.FindOrAdd(FObjectKey(Class));
+		Count += Delta;
+		if (Count <= 0)
+		{
+			AttributeSetClassCounts.Remove(FObjectKey(Class));
+		}
 	}
+}
 
-	if (Spec)
+void UKaosAbilitySystemComponent::RebuildAttributeSetClasses() const
+{
+	AttributeSetClassCounts.Reset();
+	NumCountedAttributeSets = 0;
+	for (const UAttributeSet* Set : GetSpawnedAttributes())
 	{
-		return Spec->IsActive();
+		CountAttributeSetClasses(Set, 1);
 	}
-	return false;
 }
 
-bool UKaosAbilitySystemComponent::IsAbilityActiveByTags(const FGameplayTagContainer* WithTags, const FGameplayTagContainer* WithoutTags, UGameplayAbility* Ignore)
+bool UKaosAbilitySystemComponent::IsAbilityTagBlocked(FGameplayTag AbilityTag)
 {
-	ABILITYLIST_SCOPE_LOCK();
-
-	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
-	{
-		if (!Spec.IsActive() || Spec.Ability == nullptr || Spec.Ability == Ignore)
-		{
-			continue;
-		}
+	return AreAbilityTagsBlocked(FGameplayTagContainer(AbilityTag));
+}
 
-		const bool WithTagPass = (!WithTags || Spec.Ability->AbilityTags.HasAny(*WithTags));
-		const bool WithoutTagPass = (!WithoutTags || !Spec.Ability->AbilityTags.HasAny(*WithoutTags));
 
-		if (WithTagPass && WithoutTagPass)
-		{
-			return true;
-		}
-	}
-	return false;
+void UKaosAbilitySystemComponent::CancelAbilityWithAllTags(const FGameplayTagContainer& GameplayAbilityTags)
+{
+	CancelAbilitiesWithAllTags(MakeArrayView(&GameplayAbilityTags, 1));
 }
 
-bool UKaosAbilitySystemComponent::HasActiveAbilityWithAnyMatchingTag(const FGameplayTagContainer Tags)
+void UKaosAbilitySystemComponent::CancelAbilitiesWithAllTags(TConstArrayView<FGameplayTagContainer> GameplayAbilityTagGroups)
 {
-	TArray<FGameplayAbilitySpec> Specs = GetActivatableAbilities();
-	for (const FGameplayAbilitySpec& Spec : Specs)
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	// Collect first, cancelling runs EndAbility and delegates which must not happen while walking the index
+	TArray<FGameplayAbilitySpecHandle, TInlineAllocator<8>> HandlesToCancel;
 	{
-		if (Spec.Ability == nullptr)
-		{
-			continue;
-		}
+		ABILITYLIST_SCOPE_LOCK();
 
-		if (Spec.Ability->AbilityTags.HasAny(Tags) && Spec.IsActive())
+		for (const FGameplayTagContainer& GameplayAbilityTags : GameplayAbilityTagGroups)
 		{
-			return true;
+			AbilitySpecIndex.ForEachHandleWithAllTags(ActivatableAbilities.Items, GameplayAbilityTags, [this, &HandlesToCancel](const FGameplayAbilitySpecHandle& Handle)
+			{
+				const FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(Handle);
+				if (AbilitySpec && AbilitySpec->IsActive())
+				{
+					HandlesToCancel.AddUnique(Handle);
+				}
+				return true;
+			});
 		}
 	}
-	return false;
-}
 
-bool UKaosAbilitySystemComponent::HasActiveAbilityWithAllMatchingTag(const FGameplayTagContainer Tags)
-{
-	TArray<FGameplayAbilitySpec> Specs = GetActivatableAbilities();
-	for (const FGameplayAbilitySpec& Spec : Specs)
+	if (HandlesToCancel.IsEmpty())
 	{
-		if (Spec.Ability == nullptr)
-		{
-			continue;
-		}
+		return;
+	}
+
+	// One lock for the whole pass, so abilities cleared as they end are removed together when it is released
+	ABILITYLIST_SCOPE_LOCK();
 
-		if (Spec.Ability->AbilityTags.HasAll(Tags) && Spec.IsActive())
+	for (const FGameplayAbilitySpecHandle& Handle : HandlesToCancel)
+	{
+		// An earlier cancel may have ended this one already
+		const FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(Handle);
+		if (AbilitySpec && AbilitySpec->IsActive())
 		{
-			return true;
+			CancelAbilityHandle(Handle);
 		}
 	}
-	return false;
 }
 
-bool UKaosAbilitySystemComponent::CanActivateAbilityWithAnyMatchingTag(const FGameplayTagContainer GameplayAbilityTags)
+void UKaosAbilitySystemComponent::K2_CancelAbilitiesWithAllTags(const TArray<FGameplayTagContainer>& GameplayAbilityTagGroups)
 {
-	TArray<FGameplayAbilitySpec> Specs = GetActivatableAbilities();
-	const FGameplayAbilityActorInfo* ActorInfo = AbilityActorInfo.Get();
-	for (const FGameplayAbilitySpec& Spec : Specs)
-	{
-		if (Spec.Ability == nullptr)
-		{
+	CancelAbilitiesWithAllTags(GameplayAbilityTagGroups);
+}
+
+bool UKaosAbilitySystemComponent::IsAbilityOnCooldownWithAllTags(const FGameplayTagContainer& GameplayAbilityTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+
+	bool bOnCooldown = false;
+	AbilitySpecIndex.ForEachHandleWithAllTags(ActivatableAbilities.Items, GameplayAbilityTags, [this, &bOnCooldown](const FGameplayAbilitySpecHandle& Handle)
+	{
+		bOnCooldown = IsAbilityOnCooldown(Handle);
+		return !bOnCooldown;
+	});
+	return bOnCooldown;
+}
+
+bool UKaosAbilitySystemComponent::IsAbilityOnCooldownWithAllTags(const FKaosResolvedAbilityTags& ResolvedTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+
+	bool bOnCooldown = false;
+	AbilitySpecIndex.ForEachHandleWithAllTags(ActivatableAbilities.Items, ResolvedTags, [this, &bOnCooldown](const FGameplayAbilitySpecHandle& Handle)
+	{
+		bOnCooldown = IsAbilityOnCooldown(Handle);
+		return !bOnCooldown;
+	});
+	return bOnCooldown;
+}
+
+bool UKaosAbilitySystemComponent::HasAbilityWithAllTags(const FGameplayTagContainer& GameplayAbilityTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+	return FindAbilitySpecWithAllTags(GameplayAbilityTags) != nullptr;
+}
+
+bool UKaosAbilitySystemComponent::HasAbilityWithAllTags(const FKaosResolvedAbilityTags& ResolvedTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+	return FindAbilitySpecWithAllTags(ResolvedTags) != nullptr;
+}
+
+bool UKaosAbilitySystemComponent::CanActivateAbilityWithAllMatchingTags(const FGameplayTagContainer& GameplayAbilityTags, FGameplayTagContainer& OutFailureTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+
+	//If tags match, return the call to CanActivateAbility for the first matching ability.
+	const FGameplayAbilitySpec* Spec = FindAbilitySpecWithAllTags(GameplayAbilityTags);
+	if (Spec && Spec->Ability)
+	{
+		return CheckCanActivateAbility(*Spec, Spec->Ability, &OutFailureTags);
+	}
+	return false;
+}
+
+bool UKaosAbilitySystemComponent::CanActivateAbilityWithAllMatchingTags(const FKaosResolvedAbilityTags& ResolvedTags, FGameplayTagContainer& OutFailureTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+
+	const FGameplayAbilitySpec* Spec = FindAbilitySpecWithAllTags(ResolvedTags);
+	if (Spec && Spec->Ability)
+	{
+		return CheckCanActivateAbility(*Spec, Spec->Ability, &OutFailureTags);
+	}
+	return false;
+}
+
+FKaosCanActivateAbilitiesResult UKaosAbilitySystemComponent::CanActivateAbilities(TConstArrayView<FGameplayTagContainer> GameplayAbilityTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	FKaosCanActivateAbilitiesResult Result;
+	Result.CanActivateMask.Init(false, GameplayAbilityTags.Num());
+	Result.FailureTags.SetNum(GameplayAbilityTags.Num());
+
+	ABILITYLIST_SCOPE_LOCK();
+
+	// Entry that first checked each ability, so entries resolving to the same ability reuse the result
+	TArray<TPair<FGameplayAbilitySpecHandle, int32>, TInlineAllocator<8>> CheckedSpecs;
+
+	for (int32 EntryIdx = 0; EntryIdx < GameplayAbilityTags.Num(); ++EntryIdx)
+	{
+		const FGameplayAbilitySpec* Spec = FindAbilitySpecWithAllTags(GameplayAbilityTags[EntryIdx]);
+		if (Spec == nullptr || Spec->Ability == nullptr)
+		{
 			continue;
 		}
 
-		if (Spec.Ability->AbilityTags.HasAny(GameplayAbilityTags) && Spec.Ability->CanActivateAbility(Spec.Handle, ActorInfo))
+		const TPair<FGameplayAbilitySpecHandle, int32>* Checked = CheckedSpecs.FindByPredicate([Spec](const TPair<FGameplayAbilitySpecHandle, int32>& Pair)
+		{
+			return Pair.Key == Spec->Handle;
+		});
+
+		if (Checked)
 		{
-			return true;
+			Result.CanActivateMask[EntryIdx] = Result.CanActivateMask[Checked->Value];
+			Result.FailureTags[EntryIdx] = Result.FailureTags[Checked->Value];
+			continue;
 		}
+
+		Result.CanActivateMask[EntryIdx] = CheckCanActivateAbility(*Spec, Spec->Ability, &Result.FailureTags[EntryIdx]);
+		CheckedSpecs.Emplace(Spec->Handle, EntryIdx);
 	}
-	return false;
+
+	return Result;
+}
+
+bool UKaosAbilitySystemComponent::IsAbilityActive(const FGameplayAbilitySpecHandle& InHandle)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+	const FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(InHandle);
+	return Spec ? Spec->IsActive() : false;
+}
+
+void UKaosAbilitySystemComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	// Picks up the attribute set default subobjects the super call registered
+	RebuildAttributeSetClasses();
+
+	OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &UKaosAbilitySystemComponent::HandleCooldownEffectAdded);
+
+	// The generic tag event fires for parent tags as well, so the bits keep holding the owned tags with their parents
+	RebuildOwnedTagBits();
+	RegisterGenericGameplayTagEvent().AddUObject(this, &UKaosAbilitySystemComponent::HandleOwnedTagBitChanged);
+
+	// Adding tags at runtime (game feature tag ini files) or editing the tree reassigns the net indices every tag bitset is keyed by
+	IGameplayTagsModule::OnGameplayTagTreeChanged.AddUObject(this, &UKaosAbilitySystemComponent::RebuildTagBits);
+#if WITH_EDITOR
+	UGameplayTagsManager::OnEditorRefreshGameplayTagTree.AddUObject(this, &UKaosAbilitySystemComponent::RebuildTagBits);
+#endif
+
+	if (bCacheCanActivateAbilityResults)
+	{
+		// Owned and blocked tag delegates fire for parent tags as well and cover every path that changes the counts
+		RegisterGenericGameplayTagEvent().AddUObject(this, &UKaosAbilitySystemComponent::HandleCanActivateTagChanged);
+		BlockedAbilityTags.RegisterGenericGameplayEvent().AddUObject(this, &UKaosAbilitySystemComponent::HandleCanActivateTagChanged);
+		OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &UKaosAbilitySystemComponent::HandleCanActivateEffectAdded);
+		OnAnyGameplayEffectRemovedDelegate().AddUObject(this, &UKaosAbilitySystemComponent::HandleCanActivateEffectRemoved);
+	}
+}
+
+void UKaosAbilitySystemComponent::UninitializeComponent()
+{
+	IGameplayTagsModule::OnGameplayTagTreeChanged.RemoveAll(this);
+#if WITH_EDITOR
+	UGameplayTagsManager::OnEditorRefreshGameplayTagTree.RemoveAll(this);
+#endif
+
+	Super::UninitializeComponent();
+}
+
+void UKaosAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor)
+{
+	Super::InitAbilityActorInfo(InOwnerActor, InAvatarActor);
+
+	InvalidateCanActivateAbilityCache();
+}
+
+bool UKaosAbilitySystemComponent::CheckCanActivateAbility(const FGameplayAbilitySpec& Spec, const UGameplayAbility* Ability, FGameplayTagContainer* OutFailureTags)
+{
+	if (Ability == nullptr)
+	{
+		return false;
+	}
+
+	if (!bCacheCanActivateAbilityResults)
+	{
+		return Ability->CanActivateAbility(Spec.Handle, AbilityActorInfo.Get(), nullptr, nullptr, OutFailureTags);
+	}
+
+	FKaosCachedCanActivateAbility& Cached = CanActivateAbilityCache.FindOrAdd(Spec.Handle);
+	if (Cached.Generation != CanActivateAbilityGeneration || Cached.Ability != Ability)
+	{
+		Cached.FailureTags.Reset();
+		Cached.bCanActivate = Ability->CanActivateAbility(Spec.Handle, AbilityActorInfo.Get(), nullptr, nullptr, &Cached.FailureTags);
+		Cached.Generation = CanActivateAbilityGeneration;
+		Cached.Ability = Ability;
+	}
+
+	if (OutFailureTags)
+	{
+		OutFailureTags->AppendTags(Cached.FailureTags);
+	}
+	return Cached.bCanActivate;
+}
+
+void UKaosAbilitySystemComponent::HandleCanActivateTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	InvalidateCanActivateAbilityCache();
+}
+
+void UKaosAbilitySystemComponent::HandleOwnedTagBitChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	if (NewCount > 0)
+	{
+		OwnedTagBits.AddTag(Tag);
+	}
+	else
+	{
+		OwnedTagBits.RemoveTag(Tag);
+	}
+}
+
+void UKaosAbilitySystemComponent::HandleCanActivateEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle)
+{
+	InvalidateCanActivateAbilityCache();
+}
+
+void UKaosAbilitySystemComponent::HandleCanActivateEffectRemoved(const FActiveGameplayEffect& EffectRemoved)
+{
+	InvalidateCanActivateAbilityCache();
 }
 
-bool UKaosAbilitySystemComponent::CanActivateAbilityWithAllMatchingTag(const FGameplayTagContainer GameplayAbilityTags)
+void UKaosAbilitySystemComponent::HandleCanActivateAttributeChanged(const FOnAttributeChangeData& ChangeData)
 {
-	TArray<FGameplayAbilitySpec> Specs = GetActivatableAbilities();
-	const FGameplayAbilityActorInfo* ActorInfo = AbilityActorInfo.Get();
-	for (const FGameplayAbilitySpec& Spec : Specs)
+	InvalidateCanActivateAbilityCache();
+}
+
+void UKaosAbilitySystemComponent::BindCostAttributesForCanActivateCache(const UGameplayAbility* Ability)
+{
+	const UGameplayEffect* CostGE = Ability ? Ability->GetCostGameplayEffect() : nullptr;
+	if (CostGE == nullptr)
+	{
+		return;
+	}
+
+	for (const FGameplayModifierInfo& ModInfo : CostGE->Modifiers)
+	{
+		if (ModInfo.Attribute.IsValid() && !CanActivateCostAttributes.Contains(ModInfo.Attribute))
+		{
+			CanActivateCostAttributes.Add(ModInfo.Attribute);
+			GetGameplayAttributeValueChangeDelegate(ModInfo.Attribute).AddUObject(this, &UKaosAbilitySystemComponent::HandleCanActivateAttributeChanged);
+		}
+	}
+}
+
+void UKaosAbilitySystemComponent::StartTimestampCooldown(const FGameplayAbilitySpecHandle& Handle, float Duration)
+{
+	if (Duration <= 0.0f)
+	{
+		return;
+	}
+
+	const double EndServerTime = GetTimestampCooldownServerTime() + Duration;
+	if (IsOwnerActorAuthoritative())
+	{
+		TimestampCooldowns.SetCooldown(Handle, EndServerTime, Duration);
+	}
+	else if (ScopedPredictionKey.IsLocalClientKey())
+	{
+		// Server never ran the activation, drop the predicted cooldown
+		ScopedPredictionKey.NewRejectedDelegate().BindWeakLambda(this, [this, Handle]()
+		{
+			ClearTimestampCooldown(Handle);
+		});
+	}
+
+	ApplyLocalTimestampCooldown(Handle, EndServerTime, Duration);
+}
+
+void UKaosAbilitySystemComponent::ClearTimestampCooldown(const FGameplayAbilitySpecHandle& Handle)
+{
+	if (IsOwnerActorAuthoritative())
+	{
+		TimestampCooldowns.RemoveCooldown(Handle);
+	}
+
+	if (LocalTimestampCooldowns.Contains(Handle))
+	{
+		RemoveLocalTimestampCooldown(Handle);
+		ScheduleTimestampCooldownExpiry();
+	}
+}
+
+bool UKaosAbilitySystemComponent::IsTimestampCooldownActive(const FGameplayAbilitySpecHandle& Handle) const
+{
+	const FKaosLocalTimestampCooldown* Cooldown = LocalTimestampCooldowns.Find(Handle);
+	return Cooldown && Cooldown->EndServerTime > GetTimestampCooldownServerTime();
+}
+
+bool UKaosAbilitySystemComponent::GetTimestampCooldownTimeRemaining(const FGameplayAbilitySpecHandle& Handle, float& TimeRemaining, float& Duration) const
+{
+	const FKaosLocalTimestampCooldown* Cooldown = LocalTimestampCooldowns.Find(Handle);
+	const double Remaining = Cooldown ? Cooldown->EndServerTime - GetTimestampCooldownServerTime() : 0.0;
+	if (Remaining <= 0.0)
+	{
+		return false;
+	}
+
+	TimeRemaining = static_cast<float>(Remaining);
+	Duration = Cooldown->Duration;
+	return true;
+}
+
+double UKaosAbilitySystemComponent::GetTimestampCooldownServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return 0.0;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void UKaosAbilitySystemComponent::OnTimestampCooldownReplicated(const FKaosAbilityCooldownEntry& Entry)
+{
+	if (Entry.EndServerTime > GetTimestampCooldownServerTime())
+	{
+		ApplyLocalTimestampCooldown(Entry.Handle, Entry.EndServerTime, Entry.Duration);
+	}
+}
+
+void UKaosAbilitySystemComponent::OnTimestampCooldownRemoved(const FGameplayAbilitySpecHandle& Handle)
+{
+	if (LocalTimestampCooldowns.Contains(Handle))
+	{
+		RemoveLocalTimestampCooldown(Handle);
+		ScheduleTimestampCooldownExpiry();
+	}
+}
+
+void UKaosAbilitySystemComponent::ApplyLocalTimestampCooldown(const FGameplayAbilitySpecHandle& Handle, double EndServerTime, float Duration)
+{
+	FKaosLocalTimestampCooldown* Cooldown = LocalTimestampCooldowns.Find(Handle);
+	if (Cooldown == nullptr)
 	{
-		if (Spec.Ability == nullptr)
+		Cooldown = &LocalTimestampCooldowns.Add(Handle);
+
+		// Predicted and replicated starts share the entry, so the tags are only added once
+		const FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handle);
+		const FGameplayTagContainer* CooldownTags = Spec && Spec->Ability ? Spec->Ability->GetCooldownTags() : nullptr;
+		if (CooldownTags && CooldownTags->Num() > 0)
+		{
+			Cooldown->CooldownTags = *CooldownTags;
+			AddLooseGameplayTags(Cooldown->CooldownTags);
+		}
+	}
+
+	Cooldown->EndServerTime = EndServerTime;
+	Cooldown->Duration = Duration;
+	ScheduleTimestampCooldownExpiry();
+
+	// Cooldown tags are optional and shared tags may not change count, so the tag events can't be relied on here
+	InvalidateCanActivateAbilityCache();
+}
+
+void UKaosAbilitySystemComponent::RemoveLocalTimestampCooldown(const FGameplayAbilitySpecHandle& Handle)
+{
+	FKaosLocalTimestampCooldown Cooldown;
+	if (!LocalTimestampCooldowns.RemoveAndCopyValue(Handle, Cooldown))
+	{
+		return;
+	}
+
+	if (Cooldown.CooldownTags.Num() > 0)
+	{
+		RemoveLooseGameplayTags(Cooldown.CooldownTags);
+	}
+	InvalidateCanActivateAbilityCache();
+}
+
+void UKaosAbilitySystemComponent::ScheduleTimestampCooldownExpiry()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	double NextEndServerTime = MAX_dbl;
+	for (const TPair<FGameplayAbilitySpecHandle, FKaosLocalTimestampCooldown>& Pair : LocalTimestampCooldowns)
+	{
+		NextEndServerTime = FMath::Min(NextEndServerTime, Pair.Value.EndServerTime);
+	}
+
+	if (NextEndServerTime == MAX_dbl)
+	{
+		World->GetTimerManager().ClearTimer(TimestampCooldownTimerHandle);
+		return;
+	}
+
+	const float Delay = FMath::Max(static_cast<float>(NextEndServerTime - GetTimestampCooldownServerTime()), KINDA_SMALL_NUMBER);
+	World->GetTimerManager().SetTimer(TimestampCooldownTimerHandle, this, &UKaosAbilitySystemComponent::HandleTimestampCooldownsExpired, Delay, false);
+}
+
+void UKaosAbilitySystemComponent::HandleTimestampCooldownsExpired()
+{
+	const double ServerTime = GetTimestampCooldownServerTime();
+
+	TArray<FGameplayAbilitySpecHandle, TInlineAllocator<8>> ExpiredHandles;
+	for (const TPair<FGameplayAbilitySpecHandle, FKaosLocalTimestampCooldown>& Pair : LocalTimestampCooldowns)
+	{
+		if (Pair.Value.EndServerTime <= ServerTime)
+		{
+			ExpiredHandles.Add(Pair.Key);
+		}
+	}
+
+	for (const FGameplayAbilitySpecHandle& Handle : ExpiredHandles)
+	{
+		RemoveLocalTimestampCooldown(Handle);
+	}
+
+	if (IsOwnerActorAuthoritative())
+	{
+		TimestampCooldowns.RemoveExpired(ServerTime);
+	}
+
+	ScheduleTimestampCooldownExpiry();
+}
+
+void UKaosAbilitySystemComponent::TrackCooldownTags(const FGameplayAbilitySpec& AbilitySpec)
+{
+	const TArray<FGameplayTag>* CooldownTags = AbilitySpecIndex.GetCooldownTags(AbilitySpec.Handle);
+	if (CooldownTags == nullptr)
+	{
+		return;
+	}
+
+	for (const FGameplayTag& Tag : *CooldownTags)
+	{
+		bool bAlreadyTracked = false;
+		TrackedCooldownTags.Add(Tag, &bAlreadyTracked);
+		if (!bAlreadyTracked)
+		{
+			// Bindings stay for the lifetime of the component, specs granted later with the same tag reuse them
+			// Any count change, a second effect granting the same tag changes the remaining time
+			RegisterGameplayTagEvent(Tag, EGameplayTagEventType::AnyCountChange).AddUObject(this, &UKaosAbilitySystemComponent::HandleCooldownTagChanged);
+			AbilitySpecIndex.SetCooldownTagActive(Tag, GetTagCount(Tag) > 0);
+		}
+	}
+}
+
+void UKaosAbilitySystemComponent::HandleCooldownTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	AbilitySpecIndex.SetCooldownTagActive(Tag, NewCount > 0);
+	CooldownTagTimings.Remove(Tag);
+}
+
+void UKaosAbilitySystemComponent::HandleCooldownEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle)
+{
+	FGameplayTagContainer GrantedTags;
+	SpecApplied.GetAllGrantedTags(GrantedTags);
+
+	// Start time and duration changes keep the tag count, so listen for them on effects granting a tracked cooldown tag
+	bool bGrantsTrackedTag = false;
+	for (const FGameplayTag& Tag : TrackedCooldownTags)
+	{
+		if (GrantedTags.HasTag(Tag))
+		{
+			bGrantsTrackedTag = true;
+			break;
+		}
+	}
+
+	if (bGrantsTrackedTag)
+	{
+		FOnActiveGameplayEffectTimeChange* TimeChangeDelegate = OnGameplayEffectTimeChangeDelegate(ActiveHandle);
+		if (TimeChangeDelegate && !TimeChangeDelegate->IsBoundToObject(this))
+		{
+			TimeChangeDelegate->AddUObject(this, &UKaosAbilitySystemComponent::HandleCooldownEffectTimeChanged);
+		}
+	}
+
+	// Stacking refreshes keep the tag count as well
+	DropCooldownTagTimings(GrantedTags);
+}
+
+void UKaosAbilitySystemComponent::HandleCooldownEffectTimeChanged(FActiveGameplayEffectHandle ActiveHandle, float NewStartTime, float NewDuration)
+{
+	const FActiveGameplayEffect* ActiveEffect = GetActiveGameplayEffect(ActiveHandle);
+	if (ActiveEffect == nullptr)
+	{
+		CooldownTagTimings.Reset();
+		return;
+	}
+
+	FGameplayTagContainer GrantedTags;
+	ActiveEffect->Spec.GetAllGrantedTags(GrantedTags);
+	DropCooldownTagTimings(GrantedTags);
+}
+
+void UKaosAbilitySystemComponent::DropCooldownTagTimings(const FGameplayTagContainer& GrantedTags)
+{
+	// Drop every cached tag the effect grants, parents included
+	for (auto It = CooldownTagTimings.CreateIterator(); It; ++It)
+	{
+		if (GrantedTags.HasTag(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+const UKaosAbilitySystemComponent::FKaosCooldownTagTiming& UKaosAbilitySystemComponent::FindOrAddCooldownTagTiming(const FGameplayTag& Tag, float WorldTime) const
+{
+	if (const FKaosCooldownTagTiming* CachedTiming = CooldownTagTimings.Find(Tag))
+	{
+		// An effect that has run out while the tag is still owned may have been refreshed without a local add, query again
+		if (!CachedTiming->bHasEffect || CachedTiming->EndTime < 0.0f || CachedTiming->EndTime > WorldTime)
+		{
+			return *CachedTiming;
+		}
+	}
+
+	FKaosCooldownTagTiming& Timing = CooldownTagTimings.Add(Tag);
+	float LongestTime = 0.0f;
+	const FGameplayEffectQuery Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(FGameplayTagContainer(Tag));
+	for (const TPair<float, float>& RemainingAndDuration : GetActiveEffectsTimeRemainingAndDuration(Query))
+	{
+		if (!Timing.bHasEffect || RemainingAndDuration.Key > LongestTime)
+		{
+			LongestTime = RemainingAndDuration.Key;
+			Timing.Duration = RemainingAndDuration.Value;
+			Timing.bHasEffect = true;
+		}
+	}
+	Timing.EndTime = LongestTime < 0.0f ? -1.0f : WorldTime + LongestTime;
+	return Timing;
+}
+
+bool UKaosAbilitySystemComponent::GetCooldownTimeRemainingForTags(const FGameplayTagContainer& CooldownTags, float& TimeRemaining, float& Duration) const
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	const UWorld* World = GetWorld();
+	const float WorldTime = World ? World->GetTimeSeconds() : 0.0f;
+
+	bool bFound = false;
+	float LongestTime = 0.0f;
+	float LongestDuration = 0.0f;
+	auto ConsiderTiming = [&bFound, &LongestTime, &LongestDuration](float Remaining, float EffectDuration)
+	{
+		if (!bFound || Remaining > LongestTime)
+		{
+			LongestTime = Remaining;
+			LongestDuration = EffectDuration;
+			bFound = true;
+		}
+	};
+
+	FGameplayTagContainer UntrackedTags;
+	for (const FGameplayTag& Tag : CooldownTags)
+	{
+		if (!TrackedCooldownTags.Contains(Tag))
+		{
+			UntrackedTags.AddTagFast(Tag);
+			continue;
+		}
+
+		if (GetTagCount(Tag) <= 0)
 		{
 			continue;
 		}
 
-		if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags) && Spec.Ability->CanActivateAbility(Spec.Handle, ActorInfo))
+		const FKaosCooldownTagTiming& Timing = FindOrAddCooldownTagTiming(Tag, WorldTime);
+		if (Timing.bHasEffect)
+		{
+			ConsiderTiming(Timing.EndTime < 0.0f ? -1.0f : FMath::Max(Timing.EndTime - WorldTime, 0.0f), Timing.Duration);
+		}
+	}
+
+	if (UntrackedTags.Num() > 0 && HasAnyMatchingGameplayTags(UntrackedTags))
+	{
+		const FGameplayEffectQuery Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(UntrackedTags);
+		for (const TPair<float, float>& RemainingAndDuration : GetActiveEffectsTimeRemainingAndDuration(Query))
+		{
+			ConsiderTiming(RemainingAndDuration.Key, RemainingAndDuration.Value);
+		}
+	}
+
+	if (bFound)
+	{
+		TimeRemaining = LongestTime;
+		Duration = LongestDuration;
+	}
+	return bFound;
+}
+
+void UKaosAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	if (bCacheCanActivateAbilityResults)
+	{
+		InvalidateCanActivateAbilityCache();
+		BindCostAttributesForCanActivateCache(AbilitySpec.Ability);
+	}
+
+	const int32 Slot = UE_PTRDIFF_TO_INT32(&AbilitySpec - ActivatableAbilities.Items.GetData());
+	AbilitySpecIndex.AddSpec(AbilitySpec, ActivatableAbilities.Items.IsValidIndex(Slot) ? Slot : INDEX_NONE);
+	TrackCooldownTags(AbilitySpec);
+
+	Super::OnGiveAbility(AbilitySpec);
+}
+
+void UKaosAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+
+	// Back out any activations that never reported ending
+	if (const int32* Activations = ActiveAbilityTagActivations.Find(AbilitySpec.Handle))
+	{
+		for (int32 Count = *Activations; Count > 0; --Count)
 		{
-			return true;
+			UpdateActiveAbilityTags(AbilitySpec.Handle, AbilitySpec.Ability, false);
 		}
 	}
+
+	AbilitySpecIndex.RemoveSpec(AbilitySpec.Handle);
+
+	ClearTimestampCooldown(AbilitySpec.Handle);
+
+	CanActivateAbilityCache.Remove(AbilitySpec.Handle);
+	InvalidateCanActivateAbilityCache();
+}
+
+FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindAbilitySpecFromTag(FGameplayTag Tag)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	// The index holds parent tags too, so verify the exact match on the candidates
+	FGameplayAbilitySpec* FoundSpec = nullptr;
+	AbilitySpecIndex.ForEachHandleWithTag(ActivatableAbilities.Items, Tag, [this, &Tag, &FoundSpec](const FGameplayAbilitySpecHandle& Handle)
+	{
+		FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handle);
+		if (Spec && Spec->Ability && Spec->Ability->AbilityTags.HasTagExact(Tag))
+		{
+			FoundSpec = Spec;
+		}
+		return FoundSpec == nullptr;
+	});
+
+	return FoundSpec;
+}
+
+FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindAbilitySpecWithAllTags(const FGameplayTagContainer& GameplayAbilityTags)
+{
+	FGameplayAbilitySpec* FoundSpec = nullptr;
+	AbilitySpecIndex.ForEachHandleWithAllTags(ActivatableAbilities.Items, GameplayAbilityTags, [this, &FoundSpec](const FGameplayAbilitySpecHandle& Handle)
+	{
+		FoundSpec = FindIndexedAbilitySpec(Handle);
+		return FoundSpec == nullptr;
+	});
+	return FoundSpec;
+}
+
+FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindAbilitySpecWithAllTags(const FKaosResolvedAbilityTags& ResolvedTags)
+{
+	FGameplayAbilitySpec* FoundSpec = nullptr;
+	AbilitySpecIndex.ForEachHandleWithAllTags(ActivatableAbilities.Items, ResolvedTags, [this, &FoundSpec](const FGameplayAbilitySpecHandle& Handle)
+	{
+		FoundSpec = FindIndexedAbilitySpec(Handle);
+		return FoundSpec == nullptr;
+	});
+	return FoundSpec;
+}
+
+FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindIndexedAbilitySpec(const FGameplayAbilitySpecHandle& Handle)
+{
+	return AbilitySpecIndex.FindSpec(ActivatableAbilities.Items, Handle);
+}
+
+void UKaosAbilitySystemComponent::UpdateActiveAbilityTags(const FGameplayAbilitySpecHandle& Handle, const UGameplayAbility* Ability, bool bActivated)
+{
+	if (!bActivated)
+	{
+		// Ignore ends we never saw the activation for
+		int32* Activations = ActiveAbilityTagActivations.Find(Handle);
+		if (!Activations)
+		{
+			return;
+		}
+		if (--(*Activations) <= 0)
+		{
+			ActiveAbilityTagActivations.Remove(Handle);
+		}
+	}
+	else
+	{
+		++ActiveAbilityTagActivations.FindOrAdd(Handle);
+	}
+
+	if (Ability == nullptr)
+	{
+		return;
+	}
+
+	for (const FGameplayTag& Tag : Ability->AbilityTags.GetGameplayTagParents())
+	{
+		const int32 TagIndex = FKaosGameplayTagBitSet::GetTagIndex(Tag);
+		if (TagIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		if (bActivated)
+		{
+			if (TagIndex >= ActiveAbilityTagCounts.Num())
+			{
+				ActiveAbilityTagCounts.SetNumZeroed(TagIndex + 1);
+			}
+			if (ActiveAbilityTagCounts[TagIndex]++ == 0)
+			{
+				ActiveAbilityTagBits.AddTagIndex(TagIndex);
+			}
+		}
+		else if (ActiveAbilityTagCounts.IsValidIndex(TagIndex) && ActiveAbilityTagCounts[TagIndex] > 0)
+		{
+			if (--ActiveAbilityTagCounts[TagIndex] == 0)
+			{
+				ActiveAbilityTagBits.RemoveTagIndex(TagIndex);
+			}
+		}
+	}
+}
+
+void UKaosAbilitySystemComponent::RebuildOwnedTagBits()
+{
+	FGameplayTagContainer OwnedTags;
+	GetOwnedGameplayTags(OwnedTags);
+	OwnedTagBits = FKaosGameplayTagBitSet::FromContainer(OwnedTags, true);
+}
+
+void UKaosAbilitySystemComponent::RebuildTagBits()
+{
+	RebuildOwnedTagBits();
+	AbilitySpecIndex.RebuildTagBits();
+
+	// Count the running activations again under the new indices
+	ActiveAbilityTagBits.Reset();
+	ActiveAbilityTagCounts.Reset();
+	for (const TPair<FGameplayAbilitySpecHandle, int32>& Pair : ActiveAbilityTagActivations)
+	{
+		const FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Pair.Key);
+		if (Spec == nullptr || Spec->Ability == nullptr)
+		{
+			continue;
+		}
+
+		for (const FGameplayTag& Tag : Spec->Ability->AbilityTags.GetGameplayTagParents())
+		{
+			const int32 TagIndex = FKaosGameplayTagBitSet::GetTagIndex(Tag);
+			if (TagIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			if (TagIndex >= ActiveAbilityTagCounts.Num())
+			{
+				ActiveAbilityTagCounts.SetNumZeroed(TagIndex + 1);
+			}
+			ActiveAbilityTagCounts[TagIndex] += Pair.Value;
+			ActiveAbilityTagBits.AddTagIndex(TagIndex);
+		}
+	}
+
+	InvalidateCanActivateAbilityCache();
+}
+
+FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindAbilitySpecByClassAndSource(TSubclassOf<UGameplayAbility> AbilityClass, UObject* SourceObject)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	return FindIndexedAbilitySpec(AbilitySpecIndex.FindHandleByClassAndSource(ActivatableAbilities.Items, AbilityClass, SourceObject));
+}
+
+
+bool UKaosAbilitySystemComponent::IsAbilityActiveByClass(TSubclassOf<UGameplayAbility> AbilityClass, UObject* SourceObject)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	ABILITYLIST_SCOPE_LOCK();
+
+	FGameplayAbilitySpec* Spec;
+
+	if (SourceObject)
+	{
+		Spec = FindAbilitySpecByClassAndSource(AbilityClass, SourceObject);
+	}
+	else
+	{
+		Spec = FindIndexedAbilitySpec(AbilitySpecIndex.FindHandleByClass(ActivatableAbilities.Items, AbilityClass));
+	}
+
+	if (Spec)
+	{
+		return Spec->IsActive();
+	}
 	return false;
 }
+
+bool UKaosAbilitySystemComponent::IsAbilityActiveByTags(const FGameplayTagContainer* WithTags, const FGameplayTagContainer* WithoutTags, UGameplayAbility* Ignore)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	return FindFirstSpec([WithTags, WithoutTags, Ignore](const FGameplayAbilitySpec& Spec)
+	{
+		if (!Spec.IsActive() || Spec.Ability == Ignore)
+		{
+			return false;
+		}
+
+		const bool WithTagPass = (!WithTags || Spec.Ability->AbilityTags.HasAny(*WithTags));
+		const bool WithoutTagPass = (!WithoutTags || !Spec.Ability->AbilityTags.HasAny(*WithoutTags));
+		return WithTagPass && WithoutTagPass;
+	}) != nullptr;
+}
+
+bool UKaosAbilitySystemComponent::HasActiveAbilityWithAnyMatchingTag(const FGameplayTagContainer& Tags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	// Bits hold parent tags too, so a set bit means an active ability has the tag or a child of it
+	return ActiveAbilityTagBits.HasAnyTags(Tags);
+}
+
+bool UKaosAbilitySystemComponent::HasActiveAbilityWithAllMatchingTag(const FGameplayTagContainer& Tags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	if (ActiveAbilityTagActivations.IsEmpty())
+	{
+		return false;
+	}
+
+	return HasActiveAbilityWithAllMatchingTag(FKaosResolvedAbilityTags(Tags));
+}
+
+bool UKaosAbilitySystemComponent::HasActiveAbilityWithAllMatchingTag(const FKaosResolvedAbilityTags& ResolvedTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	if (ActiveAbilityTagActivations.IsEmpty())
+	{
+		return false;
+	}
+
+	// Every tag has to be held by some active ability, otherwise no single one can have all of them
+	if (!ResolvedTags.AreAllTagsIn(ActiveAbilityTagBits))
+	{
+		return false;
+	}
+
+	// The bits are a union over all active abilities, so with more than one tag confirm a single ability has all of them
+	if (ResolvedTags.Tags.Num() <= 1)
+	{
+		return true;
+	}
+
+	ABILITYLIST_SCOPE_LOCK();
+	bool bFound = false;
+	AbilitySpecIndex.ForEachHandleWithAllTags(ActivatableAbilities.Items, ResolvedTags, [this, &bFound](const FGameplayAbilitySpecHandle& Handle)
+	{
+		const FGameplayAbilitySpec* Spec = FindIndexedAbilitySpec(Handle);
+		bFound = Spec && Spec->IsActive();
+		return !bFound;
+	});
+	return bFound;
+}
+
+bool UKaosAbilitySystemComponent::CanActivateAbilityWithAnyMatchingTag(const FGameplayTagContainer& GameplayAbilityTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	return FindFirstSpec([this, &GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
+	{
+		return Spec.Ability->AbilityTags.HasAny(GameplayAbilityTags) && CheckCanActivateAbility(Spec, Spec.Ability, nullptr);
+	}) != nullptr;
+}
+
+bool UKaosAbilitySystemComponent::CanActivateAbilityWithAllMatchingTag(const FGameplayTagContainer& GameplayAbilityTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	return FindFirstSpec([this, &GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
+	{
+		return Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags) && CheckCanActivateAbility(Spec, Spec.Ability, nullptr);
+	}) != nullptr;
+}
@@ -19,59 +19,459 @@
 // DEALINGS IN THE SOFTWARE.
 
 #include "AbilitySystem/KaosAbilityTagRelationships.h"
+#include "Algo/BinarySearch.h"
+#include "Containers/SortedMap.h"
+#include "GameplayTagsManager.h"
+#include "GameplayTagsModule.h"
+#include "KaosGASCustomVersion.h"
+#include "KaosUtilitiesStats.h"
+#include "Misc/DataValidation.h"
 
-void UKaosAbilityTagRelationships::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+#define LOCTEXT_NAMESPACE "KaosAbilityTagRelationships"
+
+namespace KaosAbilityTagRelationships_Impl
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	/** Upper bound on memoized ability tag containers, the cache starts over once it is reached */
+	static constexpr int32 MaxResolvedRelationships = 256;
+
+	static uint32 HashAbilityTags(const FGameplayTagContainer& AbilityTags)
 	{
-		const FKaosAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		uint32 Hash = 0;
+		for (const FGameplayTag& Tag : AbilityTags)
 		{
-			if (OutTagsToBlock)
-			{
-				OutTagsToBlock->AppendTags(Tags.AbilityTagsToBlock);
-			}
-			if (OutTagsToCancel)
+			Hash = HashCombine(Hash, GetTypeHash(Tag));
+		}
+		return Hash;
+	}
+
+	static void AppendTagIndices(const FGameplayTagContainer& Tags, TArray<uint16>& OutTagIndices)
+	{
+		for (const FGameplayTag& Tag : Tags)
+		{
+			const int32 TagIndex = FKaosGameplayTagBitSet::GetTagIndex(Tag);
+			if (TagIndex != INDEX_NONE)
 			{
-				OutTagsToCancel->AppendTags(Tags.AbilityTagsToCancel);
+				OutTagIndices.Add(static_cast<uint16>(TagIndex));
 			}
 		}
 	}
+
+	static void AppendTags(TConstArrayView<uint16> TagIndices, FGameplayTagContainer& OutTags)
+	{
+		const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+		for (const uint16 TagIndex : TagIndices)
+		{
+			OutTags.AddTag(TagsManager.GetTagFromNetIndex(TagIndex));
+		}
+	}
 }
 
-void UKaosAbilityTagRelationships::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+TConstArrayView<uint16> FKaosAbilityTagRelationshipBlob::GetList(int32 Entry, EList List) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	const int32 Idx = Entry * NumLists + List;
+	return MakeConstArrayView(ListTagIndices).Slice(ListOffsets[Idx], ListOffsets[Idx + 1] - ListOffsets[Idx]);
+}
+
+TConstArrayView<uint64> FKaosAbilityTagRelationshipBlob::GetBitSet(int32 Entry, EBitSet BitSet) const
+{
+	const int32 Idx = Entry * NumBitSets + BitSet;
+	return MakeConstArrayView(Words).Slice(BitSetOffsets[Idx], BitSetOffsets[Idx + 1] - BitSetOffsets[Idx]);
+}
+
+TConstArrayView<uint64> FKaosAbilityTagRelationshipBlob::GetActionBitSet(int32 Entry) const
+{
+	return MakeConstArrayView(Words).Slice(ActionBitSetOffsets[Entry], ActionBitSetOffsets[Entry + 1] - ActionBitSetOffsets[Entry]);
+}
+
+void FKaosAbilityTagRelationshipBlob::Reset()
+{
+	TagTableHash = 0;
+	AbilityTagIndices.Reset();
+	ListOffsets.Reset();
+	ListTagIndices.Reset();
+	BitSetOffsets.Reset();
+	ActionTagIndices.Reset();
+	ActionBitSetOffsets.Reset();
+	Words.Reset();
+}
+
+int32 FKaosAbilityTagRelationshipBlob::FindTagIndex(const TArray<uint16>& SortedTagIndices, int32 TagIndex)
+{
+	if (TagIndex == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+	return Algo::BinarySearch(SortedTagIndices, static_cast<uint16>(TagIndex));
+}
+
+FArchive& operator<<(FArchive& Ar, FKaosAbilityTagRelationshipBlob& Blob)
+{
+	Ar << Blob.TagTableHash;
+	Ar << Blob.AbilityTagIndices;
+	Ar << Blob.ListOffsets;
+	Ar << Blob.ListTagIndices;
+	Ar << Blob.BitSetOffsets;
+	Ar << Blob.ActionTagIndices;
+	Ar << Blob.ActionBitSetOffsets;
+	Ar << Blob.Words;
+	return Ar;
+}
+
+void UKaosAbilityTagRelationships::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Objects made with NewObject never see PostLoad, loaded ones compile there once their properties are in
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_NeedLoad))
+	{
+		CompileRelationships();
+	}
+
+	// The compiled relationships are keyed by tag net index, which moves when tags are added at runtime (game feature
+	// tag ini files) or the tree is edited. Children are expanded when compiling, so new children are picked up too.
+	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
-		const FKaosAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		IGameplayTagsModule::OnGameplayTagTreeChanged.AddUObject(this, &UKaosAbilityTagRelationships::CompileRelationships);
+#if WITH_EDITOR
+		UGameplayTagsManager::OnEditorRefreshGameplayTagTree.AddUObject(this, &UKaosAbilityTagRelationships::CompileRelationships);
+#endif
+	}
+}
+
+void UKaosAbilityTagRelationships::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Ar.UsingCustomVersion(FKaosGASCustomVersion::GUID);
+
+	// Only cooked packages carry the compiled relationships, editor packages keep their existing layout
+	const bool bHasBlob = Ar.IsSaving() || Ar.CustomVer(FKaosGASCustomVersion::GUID) >= FKaosGASCustomVersion::CookedAbilityTagRelationships;
+	if ((Ar.IsCooking() || Ar.IsLoadingFromCookedPackage()) && bHasBlob)
+	{
+		Ar << CompiledRelationships;
+		bHasBakedRelationships = Ar.IsLoading();
+	}
+}
+
+void UKaosAbilityTagRelationships::PostLoad()
+{
+	Super::PostLoad();
+
+	// Baked relationships are used in place, unless the tag table changed since cooking and moved the net indices
+	if (!bHasBakedRelationships || CompiledRelationships.TagTableHash != UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndexHash())
+	{
+		CompileRelationships();
+	}
+}
+
+void UKaosAbilityTagRelationships::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// Bake against the tag table the cook sees
+	if (SaveContext.IsCooking())
+	{
+		CompileRelationships();
+	}
+}
+
+void UKaosAbilityTagRelationships::BeginDestroy()
+{
+	IGameplayTagsModule::OnGameplayTagTreeChanged.RemoveAll(this);
+#if WITH_EDITOR
+	UGameplayTagsManager::OnEditorRefreshGameplayTagTree.RemoveAll(this);
+#endif
+
+	Super::BeginDestroy();
+}
+
+#if WITH_EDITOR
+void UKaosAbilityTagRelationships::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	CompileRelationships();
+}
+
+void UKaosAbilityTagRelationships::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	CompileRelationships();
+}
+
+EDataValidationResult UKaosAbilityTagRelationships::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = CombineDataValidationResults(Super::IsDataValid(Context), EDataValidationResult::Valid);
+
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+	for (int32 Idx = 0; Idx < AbilityTagRelationships.Num(); ++Idx)
+	{
+		const FKaosAbilityTagRelationship& Relationship = AbilityTagRelationships[Idx];
+
+		// Relationships are compiled by tag net index, a tag missing from the tag table would be dropped without a trace
+		auto ValidateTag = [&TagsManager, &Context, &Result, Idx](const FGameplayTag& Tag, const TCHAR* PropertyName)
 		{
-			if (OutActivationRequired)
+			if (!Tag.GetTagName().IsNone() && !TagsManager.RequestGameplayTag(Tag.GetTagName(), false).IsValid())
 			{
-				OutActivationRequired->AppendTags(Tags.ActivationRequiredTags);
+				Context.AddError(FText::Format(LOCTEXT("MissingTag", "AbilityTagRelationships[{0}].{1} references {2}, which is not in the gameplay tag table"),
+				                               Idx, FText::FromString(PropertyName), FText::FromName(Tag.GetTagName())));
+				Result = EDataValidationResult::Invalid;
 			}
-			if (OutActivationBlocked)
+		};
+
+		ValidateTag(Relationship.AbilityTag, TEXT("AbilityTag"));
+		for (const FGameplayTag& Tag : Relationship.AbilityTagsToBlock)
+		{
+			ValidateTag(Tag, TEXT("AbilityTagsToBlock"));
+		}
+		for (const FGameplayTag& Tag : Relationship.AbilityTagsToCancel)
+		{
+			ValidateTag(Tag, TEXT("AbilityTagsToCancel"));
+		}
+		for (const FGameplayTag& Tag : Relationship.ActivationRequiredTags)
+		{
+			ValidateTag(Tag, TEXT("ActivationRequiredTags"));
+		}
+		for (const FGameplayTag& Tag : Relationship.ActivationBlockedTags)
+		{
+			ValidateTag(Tag, TEXT("ActivationBlockedTags"));
+		}
+	}
+
+	return Result;
+}
+#endif	// WITH_EDITOR
+
+void UKaosAbilityTagRelationships::CompileRelationships()
+{
+	using namespace KaosAbilityTagRelationships_Impl;
+
+	{
+		FWriteScopeLock WriteLock(ResolvedRelationshipsLock);
+		ResolvedRelationships.Reset();
+	}
+
+	UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+
+	// Merge per tag net index first, the sorted maps give the order the blob is searched in
+	TSortedMap<int32, FKaosCompiledAbilityTagRelationship> MergedRelationships;
+	TSortedMap<int32, FKaosGameplayTagBitSet> CancelledTagBits;
+	for (const FKaosAbilityTagRelationship& Relationship : AbilityTagRelationships)
+	{
+		// Tags outside the tag table have no net index, IsDataValid reports them
+		const int32 ActionTagIndex = FKaosGameplayTagBitSet::GetTagIndex(Relationship.AbilityTag);
+		if (!Relationship.AbilityTag.IsValid() || ActionTagIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		CancelledTagBits.FindOrAdd(ActionTagIndex).Append(FKaosGameplayTagBitSet::FromContainer(Relationship.AbilityTagsToCancel, true));
+
+		// An ability matches the entry through the tag or any child of it (HasTag semantics)
+		FGameplayTagContainer MatchingTags = TagsManager.RequestGameplayTagChildren(Relationship.AbilityTag);
+		MatchingTags.AddTagFast(Relationship.AbilityTag);
+
+		for (const FGameplayTag& Tag : MatchingTags)
+		{
+			const int32 TagIndex = FKaosGameplayTagBitSet::GetTagIndex(Tag);
+			if (TagIndex == INDEX_NONE)
 			{
-				OutActivationBlocked->AppendTags(Tags.ActivationBlockedTags);
+				continue;
 			}
+
+			FKaosCompiledAbilityTagRelationship& Merged = MergedRelationships.FindOrAdd(TagIndex);
+			Merged.AbilityTagsToBlock.AppendTags(Relationship.AbilityTagsToBlock);
+			Merged.AbilityTagsToCancel.AppendTags(Relationship.AbilityTagsToCancel);
+			Merged.ActivationRequiredTags.AppendTags(Relationship.ActivationRequiredTags);
+			Merged.ActivationBlockedTags.AppendTags(Relationship.ActivationBlockedTags);
 		}
 	}
+
+	FKaosAbilityTagRelationshipBlob& Blob = CompiledRelationships;
+	Blob.Reset();
+	Blob.TagTableHash = TagsManager.GetNetworkGameplayTagNodeIndexHash();
+
+	// Lists and bitsets are added in EList and EBitSet order
+	auto AddList = [&Blob](const FGameplayTagContainer& Tags)
+	{
+		Blob.ListOffsets.Add(Blob.ListTagIndices.Num());
+		AppendTagIndices(Tags, Blob.ListTagIndices);
+	};
+	auto AddBitSet = [&Blob](TArray<int32>& Offsets, const FKaosGameplayTagBitSet& BitSet)
+	{
+		Offsets.Add(Blob.Words.Num());
+		Blob.Words.Append(BitSet.GetWords().GetData(), BitSet.GetWords().Num());
+	};
+
+	for (const TPair<int32, FKaosCompiledAbilityTagRelationship>& Pair : MergedRelationships)
+	{
+		const FKaosCompiledAbilityTagRelationship& Merged = Pair.Value;
+		Blob.AbilityTagIndices.Add(static_cast<uint16>(Pair.Key));
+
+		AddList(Merged.AbilityTagsToBlock);
+		AddList(Merged.AbilityTagsToCancel);
+		AddList(Merged.ActivationRequiredTags);
+		AddList(Merged.ActivationBlockedTags);
+
+		AddBitSet(Blob.BitSetOffsets, FKaosGameplayTagBitSet::FromContainer(Merged.AbilityTagsToCancel));
+		AddBitSet(Blob.BitSetOffsets, FKaosGameplayTagBitSet::FromContainer(Merged.ActivationRequiredTags));
+		AddBitSet(Blob.BitSetOffsets, FKaosGameplayTagBitSet::FromContainer(Merged.ActivationBlockedTags));
+	}
+	Blob.ListOffsets.Add(Blob.ListTagIndices.Num());
+	Blob.BitSetOffsets.Add(Blob.Words.Num());
+
+	for (const TPair<int32, FKaosGameplayTagBitSet>& Pair : CancelledTagBits)
+	{
+		Blob.ActionTagIndices.Add(static_cast<uint16>(Pair.Key));
+		AddBitSet(Blob.ActionBitSetOffsets, Pair.Value);
+	}
+	Blob.ActionBitSetOffsets.Add(Blob.Words.Num());
+
+	Blob.AbilityTagIndices.Shrink();
+	Blob.ListOffsets.Shrink();
+	Blob.ListTagIndices.Shrink();
+	Blob.BitSetOffsets.Shrink();
+	Blob.ActionTagIndices.Shrink();
+	Blob.ActionBitSetOffsets.Shrink();
+	Blob.Words.Shrink();
+}
+
+template <typename FuncType>
+void UKaosAbilityTagRelationships::VisitResolvedRelationships(const FGameplayTagContainer& AbilityTags, FuncType&& Func) const
+{
+	using namespace KaosAbilityTagRelationships_Impl;
+
+	const uint32 Hash = HashAbilityTags(AbilityTags);
+	{
+		FReadScopeLock ReadLock(ResolvedRelationshipsLock);
+		const FResolvedRelationships* Resolved = ResolvedRelationships.Find(Hash);
+		if (Resolved && Resolved->AbilityTags == AbilityTags)
+		{
+			Func(Resolved->Relationships);
+			return;
+		}
+	}
+
+	FResolvedRelationships Resolved;
+	Resolved.AbilityTags = AbilityTags;
+	const FKaosAbilityTagRelationshipBlob& Blob = CompiledRelationships;
+	for (const FGameplayTag& AbilityTag : AbilityTags)
+	{
+		const int32 Entry = Blob.FindAbilityTag(FKaosGameplayTagBitSet::GetTagIndex(AbilityTag));
+		if (Entry == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FKaosCompiledAbilityTagRelationship& Relationships = Resolved.Relationships;
+		AppendTags(Blob.GetList(Entry, FKaosAbilityTagRelationshipBlob::TagsToBlock), Relationships.AbilityTagsToBlock);
+		AppendTags(Blob.GetList(Entry, FKaosAbilityTagRelationshipBlob::TagsToCancel), Relationships.AbilityTagsToCancel);
+		AppendTags(Blob.GetList(Entry, FKaosAbilityTagRelationshipBlob::RequiredTags), Relationships.ActivationRequiredTags);
+		AppendTags(Blob.GetList(Entry, FKaosAbilityTagRelationshipBlob::BlockedTags), Relationships.ActivationBlockedTags);
+		Relationships.AbilityTagsToCancelBits.AppendWords(Blob.GetBitSet(Entry, FKaosAbilityTagRelationshipBlob::CancelBits));
+		Relationships.ActivationRequiredTagBits.AppendWords(Blob.GetBitSet(Entry, FKaosAbilityTagRelationshipBlob::RequiredBits));
+		Relationships.ActivationBlockedTagBits.AppendWords(Blob.GetBitSet(Entry, FKaosAbilityTagRelationshipBlob::BlockedBits));
+	}
+	Func(Resolved.Relationships);
+
+	FWriteScopeLock WriteLock(ResolvedRelationshipsLock);
+	if (ResolvedRelationships.Num() >= MaxResolvedRelationships)
+	{
+		ResolvedRelationships.Reset();
+	}
+	// A hash collision replaces the other container's entry
+	ResolvedRelationships.Add(Hash, MoveTemp(Resolved));
+}
+
+void UKaosAbilityTagRelationships::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+{
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	VisitResolvedRelationships(AbilityTags, [OutTagsToBlock, OutTagsToCancel](const FKaosCompiledAbilityTagRelationship& Relationships)
+	{
+		if (OutTagsToBlock)
+		{
+			OutTagsToBlock->AppendTags(Relationships.AbilityTagsToBlock);
+		}
+		if (OutTagsToCancel)
+		{
+			OutTagsToCancel->AppendTags(Relationships.AbilityTagsToCancel);
+		}
+	});
+}
+
+void UKaosAbilityTagRelationships::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+{
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	VisitResolvedRelationships(AbilityTags, [OutActivationRequired, OutActivationBlocked](const FKaosCompiledAbilityTagRelationship& Relationships)
+	{
+		if (OutActivationRequired)
+		{
+			OutActivationRequired->AppendTags(Relationships.ActivationRequiredTags);
+		}
+		if (OutActivationBlocked)
+		{
+			OutActivationBlocked->AppendTags(Relationships.ActivationBlockedTags);
+		}
+	});
+}
+
+void UKaosAbilityTagRelationships::GetAbilityTagsToBlockAndCancelBits(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FKaosGameplayTagBitSet* OutTagsToCancel) const
+{
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	VisitResolvedRelationships(AbilityTags, [OutTagsToBlock, OutTagsToCancel](const FKaosCompiledAbilityTagRelationship& Relationships)
+	{
+		if (OutTagsToBlock)
+		{
+			OutTagsToBlock->AppendTags(Relationships.AbilityTagsToBlock);
+		}
+		if (OutTagsToCancel)
+		{
+			OutTagsToCancel->Append(Relationships.AbilityTagsToCancelBits);
+		}
+	});
+}
+
+void UKaosAbilityTagRelationships::VisitActivationTagBits(const FGameplayTagContainer& AbilityTags, TFunctionRef<void(const FKaosGameplayTagBitSet& RequiredTagBits, const FKaosGameplayTagBitSet& BlockedTagBits)> Func) const
+{
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	VisitResolvedRelationships(AbilityTags, [&Func](const FKaosCompiledAbilityTagRelationship& Relationships)
+	{
+		Func(Relationships.ActivationRequiredTagBits, Relationships.ActivationBlockedTagBits);
+	});
 }
 
 bool UKaosAbilityTagRelationships::IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	const int32 Entry = CompiledRelationships.FindActionTag(FKaosGameplayTagBitSet::GetTagIndex(ActionTag));
+	if (Entry == INDEX_NONE)
 	{
-		const FKaosAbilityTagRelationship& Tags = AbilityTagRelationships[i];
+		return false;
+	}
 
-		if (Tags.AbilityTag == ActionTag && Tags.AbilityTagsToCancel.HasAny(AbilityTags))
+	const TConstArrayView<uint64> CancelledTagWords = CompiledRelationships.GetActionBitSet(Entry);
+	for (const FGameplayTag& AbilityTag : AbilityTags)
+	{
+		if (FKaosGameplayTagBitSet::WordsHaveTagIndex(CancelledTagWords, FKaosGameplayTagBitSet::GetTagIndex(AbilityTag)))
 		{
 			return true;
 		}
 	}
-
 	return false;
 }
+
+bool UKaosAbilityTagRelationships::IsAbilityCancelledByTag(const FKaosGameplayTagBitSet& AbilityTagBits, const FGameplayTag& ActionTag) const
+{
+	KAOS_GAS_SCOPE(TagRelationships);
+
+	const int32 Entry = CompiledRelationships.FindActionTag(FKaosGameplayTagBitSet::GetTagIndex(ActionTag));
+	return Entry != INDEX_NONE && FKaosGameplayTagBitSet::WordsHaveAny(CompiledRelationships.GetActionBitSet(Entry), AbilityTagBits.GetWords());
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -24,6 +24,7 @@
 #include "GameplayEffectExtension.h"
 #include "AbilitySystem/KaosAbilitySystemComponent.h"
 #include "AbilitySystem/KaosAbilitySystemGlobals.h"
+#include "KaosUtilitiesStats.h"
 
 
 TSubclassOf<UAttributeSet> CommonFindBestAttributeClass(TArray<TSubclassOf<UAttributeSet>>& ClassList, FString PartialName)
@@ -49,6 +50,8 @@ TSubclassOf<UAttributeSet> CommonFindBestAttributeClass(TArray<TSubclassOf<UAttr
  */
 void FKaosAttributeSetInitter::PreloadAttributeSetData(const TArray<UCurveTable*>& CurveData)
 {
+	KAOS_GAS_SCOPE(AttributeInit);
+
 	if (!ensure(CurveData.Num() > 0))
 	{
 		return;
@@ -174,6 +177,8 @@ void FKaosAttributeSetInitter::PreloadAttributeSetData(const TArray<UCurveTable*
 
 void FKaosAttributeSetInitter::InitAttributeSetDefaults(UAbilitySystemComponent* AbilitySystemComponent, FName GroupName, int32 Level, bool bInitialInit) const
 {
+	KAOS_GAS_SCOPE(AttributeInit);
+
 	check(AbilitySystemComponent != nullptr);
 
 	const FKaosAttributeSetDefaultsCollection* Collection = Defaults.Find(GroupName);
@@ -234,6 +239,8 @@ void FKaosAttributeSetInitter::InitAttributeSetDefaults(UAbilitySystemComponent*
 
 void FKaosAttributeSetInitter::ApplyAttributeDefault(UAbilitySystemComponent* AbilitySystemComponent, FGameplayAttribute& InAttribute, FName GroupName, int32 Level) const
 {
+	KAOS_GAS_SCOPE(AttributeInit);
+
 	const FKaosAttributeSetDefaultsCollection* Collection = Defaults.Find(GroupName);
 	if (!Collection)
 	{
@@ -26,6 +26,7 @@
 #include "AbilitySystemLog.h"
 #include "AbilitySystem/KaosAbilityCosts.h"
 #include "AbilitySystem/KaosAbilitySystemComponent.h"
+#include "KaosUtilitiesStats.h"
 
 #define ENSURE_ABILITY_IS_INSTANTIATED_OR_RETURN(FunctionName, ReturnValue)																				\
 {																																						\
@@ -70,39 +71,62 @@ bool UKaosGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilitySyste
 	 */
 
 	const UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(&AbilitySystemComponent);
-	static FGameplayTagContainer AbilityRequiredTags;
-	AbilityRequiredTags = ActivationRequiredTags;
-
-	static FGameplayTagContainer AbilityBlockedTags;
-	AbilityBlockedTags = ActivationBlockedTags;
-
-	// This gets the additional tags from the ASC's relationship mapping for the abilities tags.
-	if (KaosAbilitySystemComponent)
+	if (KaosAbilitySystemComponent && KaosAbilitySystemComponent->UsesOwnedTagBits())
 	{
-		KaosAbilitySystemComponent->GetRelationshipActivationTagRequirements(AbilityTags, AbilityRequiredTags, AbilityBlockedTags);
-	}
+		// The Kaos ASC mirrors its owned tags, parents included, into a tag bitset. The ability's own requirements are
+		// probed bit by bit and the relationship requirements, precompiled to bitsets, are tested a word at a time.
+		const FKaosGameplayTagBitSet& OwnedTagBits = KaosAbilitySystemComponent->GetOwnedTagBits();
+		bool bOwnedTagsBlocked = OwnedTagBits.HasAnyTags(ActivationBlockedTags);
+		bool bOwnedTagsMissing = !OwnedTagBits.HasAllTags(ActivationRequiredTags);
 
-	/*
-	 * End of relationship code
-	 */
+		KaosAbilitySystemComponent->VisitRelationshipActivationTagBits(AbilityTags, [&OwnedTagBits, &bOwnedTagsBlocked, &bOwnedTagsMissing](const FKaosGameplayTagBitSet& RequiredTagBits, const FKaosGameplayTagBitSet& BlockedTagBits)
+		{
+			bOwnedTagsBlocked |= OwnedTagBits.HasAny(BlockedTagBits);
+			bOwnedTagsMissing |= !OwnedTagBits.HasAll(RequiredTagBits);
+		});
+
+		if (bOwnedTagsBlocked)
+		{
+			// Only the blocked notification needs the owned tags as a container
+			FGameplayTagContainer AbilitySystemComponentTags;
+			AbilitySystemComponent.GetOwnedGameplayTags(AbilitySystemComponentTags);
+			NotifyAbilityBlocked(AbilitySystemComponentTags, OptionalRelevantTags);
+			bBlocked = true;
+		}
 
-	// Check to see the required/blocked tags for this ability
-	if (AbilityBlockedTags.Num() || AbilityRequiredTags.Num())
+		bMissing |= bOwnedTagsMissing;
+	}
+	else
 	{
-		static FGameplayTagContainer AbilitySystemComponentTags;
+		static FGameplayTagContainer AbilityRequiredTags;
+		AbilityRequiredTags = ActivationRequiredTags;
 
-		AbilitySystemComponentTags.Reset();
-		AbilitySystemComponent.GetOwnedGameplayTags(AbilitySystemComponentTags);
+		static FGameplayTagContainer AbilityBlockedTags;
+		AbilityBlockedTags = ActivationBlockedTags;
 
-		if (AbilitySystemComponentTags.HasAny(AbilityBlockedTags))
+		// This gets the additional tags from the ASC's relationship mapping for the abilities tags.
+		if (KaosAbilitySystemComponent)
 		{
-			NotifyAbilityBlocked(AbilitySystemComponentTags, OptionalRelevantTags);
-			bBlocked = true;
+			KaosAbilitySystemComponent->GetRelationshipActivationTagRequirements(AbilityTags, AbilityRequiredTags, AbilityBlockedTags);
 		}
 
-		if (!AbilitySystemComponentTags.HasAll(AbilityRequiredTags))
+		// Check to see the required/blocked tags for this ability
+		if (AbilityBlockedTags.Num() || AbilityRequiredTags.Num())
 		{
-			bMissing = true;
+			static FGameplayTagContainer AbilitySystemComponentTags;
+			AbilitySystemComponentTags.Reset();
+			AbilitySystemComponent.GetOwnedGameplayTags(AbilitySystemComponentTags);
+
+			if (AbilitySystemComponentTags.HasAny(AbilityBlockedTags))
+			{
+				NotifyAbilityBlocked(AbilitySystemComponentTags, OptionalRelevantTags);
+				bBlocked = true;
+			}
+
+			if (!AbilitySystemComponentTags.HasAll(AbilityRequiredTags))
+			{
+				bMissing = true;
+			}
 		}
 	}
 
@@ -161,6 +185,8 @@ bool UKaosGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilitySyste
 bool UKaosGameplayAbility::CanActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags,
                                               FGameplayTagContainer* OptionalRelevantTags) const
 {
+	KAOS_GAS_SCOPE(CanActivate);
+
 	if (!ActorInfo || !ActorInfo->AbilitySystemComponent.IsValid())
 	{
 		return false;
@@ -290,6 +316,79 @@ bool UKaosGameplayAbility::CheckCost(const FGameplayAbilitySpecHandle Handle, co
 	return true;
 }
 
+const FGameplayTagContainer* UKaosGameplayAbility::GetCooldownTags() const
+{
+	if (CooldownMode == EKaosAbilityCooldownMode::Timestamp)
+	{
+		return &TimestampCooldownTags;
+	}
+	return Super::GetCooldownTags();
+}
+
+bool UKaosGameplayAbility::CheckCooldown(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, FGameplayTagContainer* OptionalRelevantTags) const
+{
+	if (CooldownMode != EKaosAbilityCooldownMode::Timestamp)
+	{
+		return Super::CheckCooldown(Handle, ActorInfo, OptionalRelevantTags);
+	}
+
+	const UKaosAbilitySystemComponent* KaosAbilitySystemComponent = ActorInfo ? Cast<UKaosAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get()) : nullptr;
+	if (KaosAbilitySystemComponent && KaosAbilitySystemComponent->IsTimestampCooldownActive(Handle))
+	{
+		if (OptionalRelevantTags)
+		{
+			const FGameplayTag& FailCooldownTag = UAbilitySystemGlobals::Get().ActivateFailCooldownTag;
+			if (FailCooldownTag.IsValid())
+			{
+				OptionalRelevantTags->AddTag(FailCooldownTag);
+			}
+			OptionalRelevantTags->AppendTags(TimestampCooldownTags);
+		}
+		return false;
+	}
+	return true;
+}
+
+void UKaosGameplayAbility::ApplyCooldown(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const
+{
+	if (CooldownMode != EKaosAbilityCooldownMode::Timestamp)
+	{
+		Super::ApplyCooldown(Handle, ActorInfo, ActivationInfo);
+		return;
+	}
+
+	UKaosAbilitySystemComponent* KaosAbilitySystemComponent = ActorInfo ? Cast<UKaosAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get()) : nullptr;
+	if (KaosAbilitySystemComponent && HasAuthorityOrPredictionKey(ActorInfo, &ActivationInfo))
+	{
+		KaosAbilitySystemComponent->StartTimestampCooldown(Handle, TimestampCooldownDuration.GetValueAtLevel(GetAbilityLevel(Handle, ActorInfo)));
+	}
+}
+
+void UKaosGameplayAbility::GetCooldownTimeRemainingAndDuration(FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, float& TimeRemaining, float& CooldownDuration) const
+{
+	const UKaosAbilitySystemComponent* KaosAbilitySystemComponent = ActorInfo ? Cast<UKaosAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get()) : nullptr;
+	if (CooldownMode != EKaosAbilityCooldownMode::Timestamp && KaosAbilitySystemComponent == nullptr)
+	{
+		Super::GetCooldownTimeRemainingAndDuration(Handle, ActorInfo, TimeRemaining, CooldownDuration);
+		return;
+	}
+
+	TimeRemaining = 0.0f;
+	CooldownDuration = 0.0f;
+	if (CooldownMode == EKaosAbilityCooldownMode::Timestamp)
+	{
+		if (KaosAbilitySystemComponent)
+		{
+			KaosAbilitySystemComponent->GetTimestampCooldownTimeRemaining(Handle, TimeRemaining, CooldownDuration);
+		}
+	}
+	else if (const FGameplayTagContainer* CooldownTags = GetCooldownTags())
+	{
+		// Served from the Kaos ASC's cooldown tag timings instead of querying every active effect
+		KaosAbilitySystemComponent->GetCooldownTimeRemainingForTags(*CooldownTags, TimeRemaining, CooldownDuration);
+	}
+}
+
 FGameplayTagContainer UKaosGameplayAbility::K2_GetCooldownTags() const
 {
 	//TODO:
@@ -20,9 +20,11 @@
 
 #include "AbilitySystem/KaosGameplayAbilitySet.h"
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/KaosAbilitySystemComponent.h"
 #include "GameplayEffect.h"
 #include "KaosUtilitiesLogging.h"
 #include "Abilities/GameplayAbility.h"
+#include "KaosUtilitiesStats.h"
 
 namespace AresAbilitySetHandle_Impl
 {
@@ -37,6 +39,8 @@ UKaosGameplayAbilitySet::UKaosGameplayAbilitySet(const FObjectInitializer& Objec
 
 FKaosAbilitySetHandle UKaosGameplayAbilitySet::GiveAbilitySetTo(UAbilitySystemComponent* ASC, UObject* OverrideSourceObject) const
 {
+	KAOS_GAS_SCOPE(AbilitySetGive);
+
 	check(ASC);
 
 	if (!ASC->IsOwnerActorAuthoritative())
@@ -98,7 +102,14 @@ FKaosAbilitySetHandle UKaosGameplayAbilitySet::GiveAbilitySetTo(UAbilitySystemCo
 		}
 
 		UAttributeSet* NewSet = NewObject<UAttributeSet>(ASC->GetOwner(), Set.AttributeSet);
-		ASC->AddSpawnedAttribute(NewSet);
+		if (UKaosAbilitySystemComponent* KaosASC = Cast<UKaosAbilitySystemComponent>(ASC))
+		{
+			KaosASC->AddAttributeSet(NewSet);
+		}
+		else
+		{
+			ASC->AddSpawnedAttribute(NewSet);
+		}
 
 		OutHandle.AddAttributeSet(NewSet);
 	}
@@ -21,9 +21,12 @@
 #include "AbilitySystem/KaosGameplayCueBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "KaosUtilitiesStats.h"
 
 void UKaosGameplayCueBlueprintLibrary::AddGameplayCueLocal(AActor* Target, const FGameplayTag& GameplayCueTag, const FGameplayCueParameters& CueParameters)
 {
+	KAOS_GAS_SCOPE(GameplayCue);
+
 	if (!Target)
 	{
 		return;
@@ -50,6 +53,8 @@ void UKaosGameplayCueBlueprintLibrary::AddGameplayCueLocal(AActor* Target, const
 
 void UKaosGameplayCueBlueprintLibrary::RemoveGameplayCueLocal(AActor* Target, const FGameplayTag& GameplayCueTag, const FGameplayCueParameters& CueParameters)
 {
+	KAOS_GAS_SCOPE(GameplayCue);
+
 	if (!Target)
 	{
 		return;
@@ -75,6 +80,8 @@ void UKaosGameplayCueBlueprintLibrary::RemoveGameplayCueLocal(AActor* Target, co
 
 void UKaosGameplayCueBlueprintLibrary::ExecuteGameplayCueLocal(AActor* Target, const FGameplayTag& GameplayCueTag, const FGameplayCueParameters& CueParameters)
 {
+	KAOS_GAS_SCOPE(GameplayCue);
+
 	if (!Target)
 	{
 		return;
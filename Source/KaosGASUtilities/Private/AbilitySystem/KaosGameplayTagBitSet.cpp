@@ -0,0 +1,234 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "AbilitySystem/KaosGameplayTagBitSet.h"
+#include "GameplayTagsManager.h"
+
+int32 FKaosGameplayTagBitSet::GetTagIndex(const FGameplayTag& Tag)
+{
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+	const FGameplayTagNetIndex NetIndex = TagsManager.GetNetIndexFromTag(Tag);
+	return NetIndex != TagsManager.GetInvalidTagNetIndex() ? static_cast<int32>(NetIndex) : INDEX_NONE;
+}
+
+FKaosGameplayTagBitSet FKaosGameplayTagBitSet::FromContainer(const FGameplayTagContainer& Container, bool bExpandParents)
+{
+	FKaosGameplayTagBitSet BitSet;
+	if (bExpandParents)
+	{
+		for (const FGameplayTag& Tag : Container.GetGameplayTagParents())
+		{
+			BitSet.AddTag(Tag);
+		}
+	}
+	else
+	{
+		for (const FGameplayTag& Tag : Container)
+		{
+			BitSet.AddTag(Tag);
+		}
+	}
+	return BitSet;
+}
+
+void FKaosGameplayTagBitSet::AddTag(const FGameplayTag& Tag)
+{
+	AddTagIndex(GetTagIndex(Tag));
+}
+
+void FKaosGameplayTagBitSet::RemoveTag(const FGameplayTag& Tag)
+{
+	RemoveTagIndex(GetTagIndex(Tag));
+}
+
+bool FKaosGameplayTagBitSet::HasTag(const FGameplayTag& Tag) const
+{
+	return HasTagIndex(GetTagIndex(Tag));
+}
+
+void FKaosGameplayTagBitSet::AddTagIndex(int32 TagIndex)
+{
+	if (TagIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 WordIndex = TagIndex / BitsPerWord;
+	if (WordIndex >= Words.Num())
+	{
+		Words.SetNumZeroed(WordIndex + 1);
+	}
+	Words[WordIndex] |= FWord(1) << (TagIndex % BitsPerWord);
+}
+
+void FKaosGameplayTagBitSet::RemoveTagIndex(int32 TagIndex)
+{
+	const int32 WordIndex = TagIndex / BitsPerWord;
+	if (TagIndex != INDEX_NONE && WordIndex < Words.Num())
+	{
+		Words[WordIndex] &= ~(FWord(1) << (TagIndex % BitsPerWord));
+	}
+}
+
+bool FKaosGameplayTagBitSet::HasTagIndex(int32 TagIndex) const
+{
+	return WordsHaveTagIndex(Words, TagIndex);
+}
+
+bool FKaosGameplayTagBitSet::HasAnyTags(const FGameplayTagContainer& Container) const
+{
+	for (const FGameplayTag& Tag : Container)
+	{
+		if (HasTag(Tag))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FKaosGameplayTagBitSet::HasAllTags(const FGameplayTagContainer& Container) const
+{
+	for (const FGameplayTag& Tag : Container)
+	{
+		if (!HasTag(Tag))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FKaosGameplayTagBitSet::AppendWords(TConstArrayView<FWord> OtherWords)
+{
+	if (OtherWords.Num() > Words.Num())
+	{
+		Words.SetNumZeroed(OtherWords.Num());
+	}
+
+	FWord* Dest = Words.GetData();
+	const FWord* Src = OtherWords.GetData();
+	for (int32 Idx = 0, Num = OtherWords.Num(); Idx < Num; ++Idx)
+	{
+		Dest[Idx] |= Src[Idx];
+	}
+}
+
+void FKaosGameplayTagBitSet::Remove(const FKaosGameplayTagBitSet& Other)
+{
+	FWord* Dest = Words.GetData();
+	const FWord* Src = Other.Words.GetData();
+	for (int32 Idx = 0, Num = FMath::Min(Words.Num(), Other.Words.Num()); Idx < Num; ++Idx)
+	{
+		Dest[Idx] &= ~Src[Idx];
+	}
+}
+
+bool FKaosGameplayTagBitSet::WordsHaveTagIndex(TConstArrayView<FWord> InWords, int32 TagIndex)
+{
+	const int32 WordIndex = TagIndex / BitsPerWord;
+	return TagIndex != INDEX_NONE && WordIndex < InWords.Num() && (InWords[WordIndex] & (FWord(1) << (TagIndex % BitsPerWord))) != 0;
+}
+
+bool FKaosGameplayTagBitSet::WordsHaveAny(TConstArrayView<FWord> InWords, TConstArrayView<FWord> OtherWords)
+{
+	const FWord* A = InWords.GetData();
+	const FWord* B = OtherWords.GetData();
+	FWord Common = 0;
+	for (int32 Idx = 0, Num = FMath::Min(InWords.Num(), OtherWords.Num()); Idx < Num; ++Idx)
+	{
+		Common |= A[Idx] & B[Idx];
+	}
+	return Common != 0;
+}
+
+bool FKaosGameplayTagBitSet::WordsHaveAll(TConstArrayView<FWord> InWords, TConstArrayView<FWord> OtherWords)
+{
+	const FWord* A = InWords.GetData();
+	const FWord* B = OtherWords.GetData();
+	const int32 NumCommon = FMath::Min(InWords.Num(), OtherWords.Num());
+
+	FWord Missing = 0;
+	for (int32 Idx = 0; Idx < NumCommon; ++Idx)
+	{
+		Missing |= B[Idx] & ~A[Idx];
+	}
+
+	// Anything the other set has past our last word is missing
+	for (int32 Idx = NumCommon; Idx < OtherWords.Num(); ++Idx)
+	{
+		Missing |= B[Idx];
+	}
+	return Missing == 0;
+}
+
+bool FKaosGameplayTagBitSet::IsEmpty() const
+{
+	FWord Any = 0;
+	for (const FWord Word : Words)
+	{
+		Any |= Word;
+	}
+	return Any == 0;
+}
+
+void FKaosGameplayTagBitSet::AppendToContainer(FGameplayTagContainer& OutContainer) const
+{
+	const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+	for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+	{
+		FWord Word = Words[WordIndex];
+		while (Word != 0)
+		{
+			const int32 Bit = static_cast<int32>(FMath::CountTrailingZeros64(Word));
+			Word &= Word - 1;
+
+			const FGameplayTag Tag = TagsManager.GetTagFromNetIndex(static_cast<FGameplayTagNetIndex>(WordIndex * BitsPerWord + Bit));
+			if (Tag.IsValid())
+			{
+				OutContainer.AddTag(Tag);
+			}
+		}
+	}
+}
+
+FGameplayTagContainer FKaosGameplayTagBitSet::ToContainer() const
+{
+	FGameplayTagContainer Container;
+	AppendToContainer(Container);
+	return Container;
+}
+
+bool FKaosGameplayTagBitSet::operator==(const FKaosGameplayTagBitSet& Other) const
+{
+	const FKaosGameplayTagBitSet& Longer = Words.Num() >= Other.Words.Num() ? *this : Other;
+	const FKaosGameplayTagBitSet& Shorter = Words.Num() >= Other.Words.Num() ? Other : *this;
+
+	FWord Diff = 0;
+	for (int32 Idx = 0; Idx < Shorter.Words.Num(); ++Idx)
+	{
+		Diff |= Longer.Words[Idx] ^ Shorter.Words[Idx];
+	}
+	for (int32 Idx = Shorter.Words.Num(); Idx < Longer.Words.Num(); ++Idx)
+	{
+		Diff |= Longer.Words[Idx];
+	}
+	return Diff == 0;
+}
@@ -19,186 +19,273 @@
 // DEALINGS IN THE SOFTWARE.
 
 #include "AbilitySystem/KaosUtilitiesBlueprintLibrary.h"
+#include "AbilitySystem/KaosAbilitySystemComponent.h"
+#include "AbilitySystem/KaosScopedAbilitySpecView.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 #include "KaosUtilitiesLogging.h"
 #include "GameplayEffect.h"
 #include "Logging/StructuredLog.h"
+#include "KaosUtilitiesStats.h"
 
-bool UKaosUtilitiesBlueprintLibrary::CanActivateAbilityWithMatchingTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags)
+namespace KaosUtilitiesBlueprintLibrary_Impl
 {
-	if (AbilitySystemComponent)
+	/**
+	 * Calls Func for every spec with an ability, without copying the spec list. Kaos ASCs iterate through ForEachSpec,
+	 * other ASCs through a scoped view. Func returns false to stop iterating.
+	 */
+	template <typename FuncType>
+	void ForEachSpec(UAbilitySystemComponent& AbilitySystemComponent, FuncType&& Func)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
+		if (UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(&AbilitySystemComponent))
+		{
+			KaosAbilitySystemComponent->ForEachSpec(Forward<FuncType>(Func));
+			return;
+		}
 
-		//Get the Actor info as we need it.
-		const FGameplayAbilityActorInfo* ActorInfo = AbilitySystemComponent->AbilityActorInfo.Get();
+		FKaosScopedAbilitySpecView Specs(AbilitySystemComponent);
+		for (FGameplayAbilitySpec& Spec : Specs)
+		{
+			if (Spec.Ability && !Func(Spec))
+			{
+				return;
+			}
+		}
+	}
+
+	/** Returns the first spec with an ability that Predicate returns true for, or null */
+	template <typename PredicateType>
+	FGameplayAbilitySpec* FindFirstSpec(UAbilitySystemComponent& AbilitySystemComponent, PredicateType&& Predicate)
+	{
+		FGameplayAbilitySpec* FoundSpec = nullptr;
+		ForEachSpec(AbilitySystemComponent, [&Predicate, &FoundSpec](FGameplayAbilitySpec& Spec)
+		{
+			if (Predicate(Spec))
+			{
+				FoundSpec = &Spec;
+				return false;
+			}
+			return true;
+		});
+		return FoundSpec;
+	}
 
-		//Loop through all specs and find if we can activate any ability
-		for (const FGameplayAbilitySpec& Spec : Specs)
+	/**
+	 * Answers a batched query for a single component. ResolvedTags is resolved once for the batch, FailureTags is
+	 * scratch space reused across it.
+	 */
+	static bool MatchesBatchQuery(UAbilitySystemComponent& AbilitySystemComponent, const FKaosResolvedAbilityTags& ResolvedTags, EKaosAbilityBatchQuery Query, FGameplayTagContainer& FailureTags)
+	{
+		if (UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(&AbilitySystemComponent))
 		{
-			//If ability cdo is null, we skip.
-			if (Spec.Ability == nullptr)
+			switch (Query)
 			{
-				continue;
+			case EKaosAbilityBatchQuery::CanActivate:
+				FailureTags.Reset();
+				return KaosAbilitySystemComponent->CanActivateAbilityWithAllMatchingTags(ResolvedTags, FailureTags);
+			case EKaosAbilityBatchQuery::HasAbility:
+				return KaosAbilitySystemComponent->HasAbilityWithAllTags(ResolvedTags);
+			case EKaosAbilityBatchQuery::IsActive:
+				return KaosAbilitySystemComponent->HasActiveAbilityWithAllMatchingTag(ResolvedTags);
+			case EKaosAbilityBatchQuery::IsOnCooldown:
+				return KaosAbilitySystemComponent->IsAbilityOnCooldownWithAllTags(ResolvedTags);
 			}
+			return false;
+		}
+
+		const FGameplayTagContainer& GameplayAbilityTags = ResolvedTags.Tags;
 
-			//If tags match and we can activate, return the call to CanActivateAbility.
-			if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
+		switch (Query)
+		{
+		case EKaosAbilityBatchQuery::CanActivate:
+			return UKaosUtilitiesBlueprintLibrary::CanActivateAbilityWithMatchingTags(&AbilitySystemComponent, GameplayAbilityTags);
+		case EKaosAbilityBatchQuery::HasAbility:
+			return UKaosUtilitiesBlueprintLibrary::HasAbilityWithAllTags(&AbilitySystemComponent, GameplayAbilityTags);
+		case EKaosAbilityBatchQuery::IsActive:
+			return FindFirstSpec(AbilitySystemComponent, [&GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
+			{
+				return Spec.IsActive() && Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags);
+			}) != nullptr;
+		case EKaosAbilityBatchQuery::IsOnCooldown:
 			{
-				return Spec.Ability->CanActivateAbility(Spec.Handle, ActorInfo);
+				float TimeRemaining = 0.0f;
+				float Duration = 0.0f;
+				return UKaosUtilitiesBlueprintLibrary::IsAbilityOnCooldownWithAllTags(&AbilitySystemComponent, GameplayAbilityTags, TimeRemaining, Duration);
 			}
 		}
+		return false;
+	}
+}
+
+bool UKaosUtilitiesBlueprintLibrary::CanActivateAbilityWithMatchingTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	if (AbilitySystemComponent)
+	{
+		//Get the Actor info as we need it.
+		const FGameplayAbilityActorInfo* ActorInfo = AbilitySystemComponent->AbilityActorInfo.Get();
+
+		//Find the first ability with all the tags and return the call to CanActivateAbility.
+		const FGameplayAbilitySpec* FoundSpec = KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
+		{
+			return Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags);
+		});
+		return FoundSpec && FoundSpec->Ability->CanActivateAbility(FoundSpec->Handle, ActorInfo);
 	}
 	return false;
 }
 
 bool UKaosUtilitiesBlueprintLibrary::HasActiveAbilityWithMatchingTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
-
 		//Get the Actor info as we need it.
 		const FGameplayAbilityActorInfo* ActorInfo = AbilitySystemComponent->AbilityActorInfo.Get();
 
-		//Loop through all specs and find if we can activate any ability
-		for (const FGameplayAbilitySpec& Spec : Specs)
+		//If tags match and the ability is active then we have the ability.
+		const FGameplayAbilitySpec* FoundSpec = KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
 		{
-			//If ability cdo is null, we skip.
-			if (Spec.Ability == nullptr)
-			{
-				continue;
-			}
-
-			//If tags match then we have the ability.
-			if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags) && Spec.IsActive())
-			{
-				return Spec.Ability->CanActivateAbility(Spec.Handle, ActorInfo);
-			}
-		}
+			return Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags) && Spec.IsActive();
+		});
+		return FoundSpec && FoundSpec->Ability->CanActivateAbility(FoundSpec->Handle, ActorInfo);
 	}
 	return false;
 }
 
 void UKaosUtilitiesBlueprintLibrary::CancelAbilityWithAllTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags)
 {
-	if (AbilitySystemComponent)
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	//The Kaos ASC collects the matches from its index before cancelling.
+	if (UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(AbilitySystemComponent))
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
+		KaosAbilitySystemComponent->CancelAbilityWithAllTags(GameplayAbilityTags);
+		return;
+	}
 
-		//Loop through all specs and find if we can activate any ability
-		for (const FGameplayAbilitySpec& Spec : Specs)
+	if (AbilitySystemComponent)
+	{
+		//If tags match, cancel the ability. Abilities cleared by the cancel are removed once the walk finishes.
+		KaosUtilitiesBlueprintLibrary_Impl::ForEachSpec(*AbilitySystemComponent, [AbilitySystemComponent, &GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
 		{
-			//If ability cdo is null, we skip.
-			if (Spec.Ability == nullptr)
-			{
-				continue;
-			}
-
-			//If tags match, cancel the ability
 			if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags) && Spec.IsActive())
 			{
 				AbilitySystemComponent->CancelAbilityHandle(Spec.Handle);
 			}
-		}
+			return true;
+		});
 	}
 }
 
 bool UKaosUtilitiesBlueprintLibrary::HasAbilityWithAllTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
-
-		//Loop through all specs and find if we can activate any ability
-		for (const FGameplayAbilitySpec& Spec : Specs)
+		//If tags match then we have the ability
+		return KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&GameplayAbilityTags](const FGameplayAbilitySpec& Spec)
 		{
-			//If ability cdo is null, we skip.
-			if (Spec.Ability == nullptr)
-			{
-				continue;
-			}
-
-			//If tags match then we have the ability
-			if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
-			{
-				return true;
-			}
-		}
+			return Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags);
+		}) != nullptr;
 	}
 	return false;
 }
 
 bool UKaosUtilitiesBlueprintLibrary::IsAbilityOnCooldownWithAllTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags, float& TimeRemaining, float& CooldownDuration)
 {
-	if (AbilitySystemComponent)
+	KAOS_GAS_SCOPE(SpecQuery);
+
+	//The Kaos ASC knows which specs are on cooldown, skip the effect query when none of the matching ones are.
+	UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(AbilitySystemComponent);
+	if (KaosAbilitySystemComponent && !KaosAbilitySystemComponent->IsAbilityOnCooldownWithAllTags(GameplayAbilityTags))
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
+		return false;
+	}
 
-		//Loop through all specs and find if we can activate any ability
-		for (const FGameplayAbilitySpec& Spec : Specs)
+	if (AbilitySystemComponent)
+	{
+		bool bOnCooldown = false;
+		KaosUtilitiesBlueprintLibrary_Impl::ForEachSpec(*AbilitySystemComponent, [AbilitySystemComponent, KaosAbilitySystemComponent, &GameplayAbilityTags, &TimeRemaining, &CooldownDuration, &bOnCooldown](const FGameplayAbilitySpec& Spec)
 		{
-			//If ability cdo is null, we skip.
-			if (Spec.Ability == nullptr)
+			//If tags match, check if the cooldown tags are applied to the ASC.
+			if (!Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
 			{
-				continue;
+				return true;
 			}
 
-			//If tags match, check if the cooldown tags are applied to the ASC.
-			if (Spec.Ability->AbilityTags.HasAll(GameplayAbilityTags))
+			//Timestamp cooldowns have no effect to query.
+			if (KaosAbilitySystemComponent && KaosAbilitySystemComponent->GetTimestampCooldownTimeRemaining(Spec.Handle, TimeRemaining, CooldownDuration))
+			{
+				bOnCooldown = true;
+				return false;
+			}
+
+			const FGameplayTagContainer* CooldownTags = Spec.Ability->GetCooldownTags();
+
+			//The Kaos ASC tracks cooldown effect timings, remaining time is a subtraction.
+			if (KaosAbilitySystemComponent)
+			{
+				if (CooldownTags && KaosAbilitySystemComponent->GetCooldownTimeRemainingForTags(*CooldownTags, TimeRemaining, CooldownDuration))
+				{
+					bOnCooldown = true;
+					return false;
+				}
+				return true;
+			}
+
+			if (CooldownTags && CooldownTags->Num() > 0 && AbilitySystemComponent->HasAnyMatchingGameplayTags(*CooldownTags))
 			{
-				const FGameplayTagContainer* CooldownTags = Spec.Ability->GetCooldownTags();
-				if (CooldownTags && CooldownTags->Num() > 0 && AbilitySystemComponent->HasAnyMatchingGameplayTags(*CooldownTags))
+				FGameplayEffectQuery const Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(*CooldownTags);
+				TArray<TPair<float, float>> DurationAndTimeRemaining = AbilitySystemComponent->GetActiveEffectsTimeRemainingAndDuration(Query);
+				if (DurationAndTimeRemaining.Num() > 0)
 				{
-					FGameplayEffectQuery const Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(*CooldownTags);
-					TArray<TPair<float, float>> DurationAndTimeRemaining = AbilitySystemComponent->GetActiveEffectsTimeRemainingAndDuration(Query);
-					if (DurationAndTimeRemaining.Num() > 0)
+					// Iterate over all the effects applying the cooldown (if there are, somehow, multiple) and find the longest
+					int32 BestIdx = 0;
+					float LongestTime = DurationAndTimeRemaining[0].Key;
+					for (int32 Idx = 1; Idx < DurationAndTimeRemaining.Num(); ++Idx)
 					{
-						// Iterate over all the effects applying the cooldown (if there are, somehow, multiple) and find the longest
-						int32 BestIdx = 0;
-						float LongestTime = DurationAndTimeRemaining[0].Key;
-						for (int32 Idx = 1; Idx < DurationAndTimeRemaining.Num(); ++Idx)
+						if (DurationAndTimeRemaining[Idx].Key > LongestTime)
 						{
-							if (DurationAndTimeRemaining[Idx].Key > LongestTime)
-							{
-								LongestTime = DurationAndTimeRemaining[Idx].Key;
-								BestIdx = Idx;
-							}
+							LongestTime = DurationAndTimeRemaining[Idx].Key;
+							BestIdx = Idx;
 						}
+					}
 
-						TimeRemaining = DurationAndTimeRemaining[BestIdx].Key;
-						CooldownDuration = DurationAndTimeRemaining[BestIdx].Value;
+					TimeRemaining = DurationAndTimeRemaining[BestIdx].Key;
+					CooldownDuration = DurationAndTimeRemaining[BestIdx].Value;
 
-						return true;
-					}
+					bOnCooldown = true;
+					return false;
 				}
 			}
-		}
+			return true;
+		});
+		return bOnCooldown;
 	}
 	return false;
 }
 
 bool UKaosUtilitiesBlueprintLibrary::CanActivateAbilityByClass(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UGameplayAbility> AbilityClass)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
+		const FGameplayAbilityActorInfo* ActorInfo = AbilitySystemComponent->AbilityActorInfo.Get();
+		const UGameplayAbility* Ability = nullptr;
+		const FGameplayAbilitySpec* FoundSpec = KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&AbilityClass, &Ability](const FGameplayAbilitySpec& Spec)
+		{
+			Ability = Spec.GetPrimaryInstance() ? Spec.GetPrimaryInstance() : Spec.Ability.Get();
+			return Ability->GetClass() == AbilityClass;
+		});
 
-		for (const FGameplayAbilitySpec& AbilitySpec : Specs)
+		if (FoundSpec)
 		{
-			const FGameplayAbilityActorInfo* ActorInfo = AbilitySystemComponent->AbilityActorInfo.Get();
-			const UGameplayAbility* Ability = AbilitySpec.GetPrimaryInstance() ? AbilitySpec.GetPrimaryInstance() : AbilitySpec.Ability.Get();
-			if (Ability->GetClass() == AbilityClass)
-			{
-				return Ability->CanActivateAbility(AbilitySpec.Handle, ActorInfo, nullptr, nullptr, nullptr);
-			}
+			return Ability->CanActivateAbility(FoundSpec->Handle, ActorInfo, nullptr, nullptr, nullptr);
 		}
 	}
 
@@ -297,44 +384,42 @@ void UKaosUtilitiesBlueprintLibrary::SetLooseGameplayTagCount(UAbilitySystemComp
 
 FGameplayAbilitySpec* UKaosUtilitiesBlueprintLibrary::FindAbilitySpecByClass(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UGameplayAbility> AbilityClass, UObject* OptionalSourceObject)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
-
-		for (FGameplayAbilitySpec& Spec : Specs)
+		return KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&AbilityClass, OptionalSourceObject](const FGameplayAbilitySpec& Spec)
 		{
 			const bool bMatchesSourceObject = OptionalSourceObject != nullptr ? OptionalSourceObject == Spec.SourceObject.Get() : true;
-			if (Spec.Ability->GetClass() == AbilityClass && bMatchesSourceObject)
-			{
-				return &Spec;
-			}
-		}
+			return Spec.Ability->GetClass() == AbilityClass && bMatchesSourceObject;
+		});
 	}
 	return nullptr;
 }
 
 FGameplayAbilitySpec* UKaosUtilitiesBlueprintLibrary::FindAbilitySpecWithAllAbilityTags(UAbilitySystemComponent* AbilitySystemComponent, FGameplayTagContainer AbilityTags, UObject* OptionalSourceObject)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
-
-		for (FGameplayAbilitySpec& Spec : Specs)
+		return KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&AbilityTags, OptionalSourceObject](const FGameplayAbilitySpec& Spec)
 		{
 			const bool bMatchesSourceObject = OptionalSourceObject != nullptr ? OptionalSourceObject == Spec.SourceObject.Get() : true;
-			if (Spec.Ability->AbilityTags.HasAll(AbilityTags) && bMatchesSourceObject)
-			{
-				return &Spec;
-			}
-		}
+			return Spec.Ability->AbilityTags.HasAll(AbilityTags) && bMatchesSourceObject;
+		});
 	}
 	return nullptr;
 }
 
 bool UKaosUtilitiesBlueprintLibrary::HasAttributeSet(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UAttributeSet> AttributeClass)
 {
+	//The Kaos ASC caches the attribute set classes it has.
+	if (const UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(AbilitySystemComponent))
+	{
+		return KaosAbilitySystemComponent->HasAttributeSet(AttributeClass);
+	}
+
 	if (AbilitySystemComponent)
 	{
 		for (const UAttributeSet* Set : AbilitySystemComponent->GetSpawnedAttributes())
@@ -359,24 +444,23 @@ bool UKaosUtilitiesBlueprintLibrary::IsAbilityTagBlocked(UAbilitySystemComponent
 
 bool UKaosUtilitiesBlueprintLibrary::IsAbilityActive(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayAbilitySpecHandle& InHandle)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
-		//Get a copy of the ability specs.
-		TArray<FGameplayAbilitySpec> Specs = AbilitySystemComponent->GetActivatableAbilities();
-
-		for (const FGameplayAbilitySpec& Spec : Specs)
+		const FGameplayAbilitySpec* FoundSpec = KaosUtilitiesBlueprintLibrary_Impl::FindFirstSpec(*AbilitySystemComponent, [&InHandle](const FGameplayAbilitySpec& Spec)
 		{
-			if (Spec.Handle == InHandle)
-			{
-				return Spec.IsActive();
-			}
-		}
+			return Spec.Handle == InHandle;
+		});
+		return FoundSpec && FoundSpec->IsActive();
 	}
 	return false;
 }
 
 bool UKaosUtilitiesBlueprintLibrary::IsAbilityActiveByClass(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UGameplayAbility> AbilityClass, UObject* OptionalSourceObject)
 {
+	KAOS_GAS_SCOPE(SpecQuery);
+
 	if (AbilitySystemComponent)
 	{
 		if (const FGameplayAbilitySpec* Spec = FindAbilitySpecByClass(AbilitySystemComponent, AbilityClass, OptionalSourceObject))
@@ -387,37 +471,65 @@ bool UKaosUtilitiesBlueprintLibrary::IsAbilityActiveByClass(UAbilitySystemCompon
 	return false;
 }
 
-bool UKaosUtilitiesBlueprintLibrary::CanApplyAttributeModifiers(UAbilitySystemComponent* AbilitySystemComponent, FGameplayEffectSpec EffectSpec)
+bool UKaosUtilitiesBlueprintLibrary::CanApplyAttributeModifiers(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec)
 {
+	//Let a Kaos ASC apply its own rules.
+	if (UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(AbilitySystemComponent))
+	{
+		return KaosAbilitySystemComponent->CanApplyAttributeModifiers(EffectSpec);
+	}
+
 	if (AbilitySystemComponent)
 	{
-		EffectSpec.CalculateModifierMagnitudes();
+		return UKaosAbilitySystemComponent::CanAbilitySystemApplyAttributeModifiers(*AbilitySystemComponent, EffectSpec);
+	}
+	return false;
+}
+
+TBitArray<> UKaosUtilitiesBlueprintLibrary::BatchQueryAbilityMask(TConstArrayView<UAbilitySystemComponent*> AbilitySystemComponents, const FGameplayTagContainer& GameplayAbilityTags, EKaosAbilityBatchQuery Query)
+{
+	KAOS_GAS_SCOPE(SpecQuery);
 
-		for (int32 ModIdx = 0; ModIdx < EffectSpec.Modifiers.Num(); ++ModIdx)
+	TBitArray<> Results(false, AbilitySystemComponents.Num());
+	const FKaosResolvedAbilityTags ResolvedTags(GameplayAbilityTags);
+	FGameplayTagContainer FailureTags;
+	for (int32 Index = 0; Index < AbilitySystemComponents.Num(); ++Index)
+	{
+		if (UAbilitySystemComponent* AbilitySystemComponent = AbilitySystemComponents[Index])
 		{
-			const FGameplayModifierInfo& ModDef = EffectSpec.Def->Modifiers[ModIdx];
-			const FModifierSpec& ModSpec = EffectSpec.Modifiers[ModIdx];
+			Results[Index] = KaosUtilitiesBlueprintLibrary_Impl::MatchesBatchQuery(*AbilitySystemComponent, ResolvedTags, Query, FailureTags);
+		}
+	}
+	return Results;
+}
 
-			// It only makes sense to check additive operators
-			if (ModDef.ModifierOp == EGameplayModOp::Additive)
-			{
-				if (!ModDef.Attribute.IsValid())
-				{
-					continue;
-				}
-				const UAttributeSet* Set = AbilitySystemComponent->GetAttributeSet(ModDef.Attribute.GetAttributeSetClass());
-				const float CurrentValue = ModDef.Attribute.GetNumericValueChecked(Set);
-				const float CostValue = ModSpec.GetEvaluatedMagnitude();
+void UKaosUtilitiesBlueprintLibrary::BatchQueryAbilities(const TArray<UAbilitySystemComponent*>& AbilitySystemComponents, const FGameplayTagContainer& GameplayAbilityTags, EKaosAbilityBatchQuery Query, TArray<UAbilitySystemComponent*>& OutMatchingAbilitySystemComponents)
+{
+	OutMatchingAbilitySystemComponents.Reset();
 
-				if (CurrentValue + CostValue < 0.f)
-				{
-					return false;
-				}
-			}
-		}
-		return true;
+	const TBitArray<> Results = BatchQueryAbilityMask(AbilitySystemComponents, GameplayAbilityTags, Query);
+	for (TConstSetBitIterator<> It(Results); It; ++It)
+	{
+		OutMatchingAbilitySystemComponents.Add(AbilitySystemComponents[It.GetIndex()]);
+	}
+}
+
+void UKaosUtilitiesBlueprintLibrary::BatchQueryAbilitiesForActors(const TArray<AActor*>& Actors, const FGameplayTagContainer& GameplayAbilityTags, EKaosAbilityBatchQuery Query, TArray<AActor*>& OutMatchingActors)
+{
+	OutMatchingActors.Reset();
+
+	TArray<UAbilitySystemComponent*, TInlineAllocator<64>> AbilitySystemComponents;
+	AbilitySystemComponents.Reserve(Actors.Num());
+	for (AActor* Actor : Actors)
+	{
+		AbilitySystemComponents.Add(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor));
+	}
+
+	const TBitArray<> Results = BatchQueryAbilityMask(AbilitySystemComponents, GameplayAbilityTags, Query);
+	for (TConstSetBitIterator<> It(Results); It; ++It)
+	{
+		OutMatchingActors.Add(Actors[It.GetIndex()]);
 	}
-	return false;
 }
 
 void UKaosUtilitiesBlueprintLibrary::BlockAbilitiesWithTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& GameplayAbilityTags)
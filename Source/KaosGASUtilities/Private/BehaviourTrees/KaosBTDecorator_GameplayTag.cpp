@@ -24,6 +24,7 @@
 #include "GameplayTagAssetInterface.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "KaosUtilitiesStats.h"
 
 struct FKaosBTDecorator_GameplayTagMemory
 {
@@ -66,6 +67,8 @@ bool UKaosBTDecorator_GameplayTag::MatchContainer(const FGameplayTagContainer& S
 
 bool UKaosBTDecorator_GameplayTag::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	const UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
 	if (!BlackboardComp)
 	{
@@ -23,6 +23,7 @@
 #include "AbilitySystemGlobals.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "KaosUtilitiesStats.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(KaosBTDecorator_GameplayTagQuery)
 
@@ -49,6 +50,8 @@ UKaosBTDecorator_GameplayTagQuery::UKaosBTDecorator_GameplayTagQuery(const FObje
 
 bool UKaosBTDecorator_GameplayTagQuery::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	const UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
 	if (!BlackboardComp)
 	{
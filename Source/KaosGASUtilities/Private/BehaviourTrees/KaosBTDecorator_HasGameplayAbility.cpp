@@ -24,6 +24,7 @@
 #include "AbilitySystem/KaosUtilitiesBlueprintLibrary.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "KaosUtilitiesStats.h"
 
 UKaosBTDecorator_HasGameplayAbility::UKaosBTDecorator_HasGameplayAbility()
 {
@@ -40,6 +41,8 @@ UKaosBTDecorator_HasGameplayAbility::UKaosBTDecorator_HasGameplayAbility()
 
 bool UKaosBTDecorator_HasGameplayAbility::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	const UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
 	if (!BlackboardComp)
 	{
@@ -24,6 +24,7 @@
 #include "AbilitySystem/KaosUtilitiesBlueprintLibrary.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "KaosUtilitiesStats.h"
 
 UKaosBTDecorator_IsAbilityOnCooldown::UKaosBTDecorator_IsAbilityOnCooldown()
 {
@@ -40,6 +41,8 @@ UKaosBTDecorator_IsAbilityOnCooldown::UKaosBTDecorator_IsAbilityOnCooldown()
 
 bool UKaosBTDecorator_IsAbilityOnCooldown::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	const UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
 	if (!BlackboardComp)
 	{
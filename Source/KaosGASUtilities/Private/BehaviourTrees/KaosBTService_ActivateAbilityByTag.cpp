@@ -24,6 +24,7 @@
 #include "AbilitySystem/KaosUtilitiesBlueprintLibrary.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "KaosUtilitiesStats.h"
 
 UKaosBTService_ActivateAbilityByTag::UKaosBTService_ActivateAbilityByTag()
 {
@@ -40,6 +41,8 @@ UKaosBTService_ActivateAbilityByTag::UKaosBTService_ActivateAbilityByTag()
 
 void UKaosBTService_ActivateAbilityByTag::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
 	const UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
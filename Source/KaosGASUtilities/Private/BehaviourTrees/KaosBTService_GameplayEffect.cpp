@@ -26,6 +26,7 @@
 #include "GameplayEffect.h"
 #include "GameplayTagAssetInterface.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "KaosUtilitiesStats.h"
 
 UKaosBTService_GameplayEffect::UKaosBTService_GameplayEffect()
 {
@@ -104,6 +105,8 @@ FString UKaosBTService_GameplayEffect::GetStaticDescription() const
 
 void UKaosBTService_GameplayEffect::ApplyGameplayEffect(UBehaviorTreeComponent& OwnerComp, bool bFromDeactivation)
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	const TSubclassOf<UGameplayEffect> ChosenGE = bFromDeactivation ? DeactivationGameplayEffect : ActivationGameplayEffect;
 	const FGameplayTagQuery& ChosenOwnerQuery = bFromDeactivation ? DeactivationOwnerTagQuery : ActivationOwnerTagQuery;
 	const FBlackboardKeySelector& ChosenEffectBlackboardKey = bFromDeactivation ? DeactivationEffectTargetBlackboardKey : ActivationEffectTargetBlackboardKey;
@@ -150,6 +153,8 @@ void UKaosBTService_GameplayEffect::ApplyGameplayEffect(UBehaviorTreeComponent&
 
 void UKaosBTService_GameplayEffect::RemoveGameplayEffect(UBehaviorTreeComponent& OwnerComp, bool bFromDeactivation)
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	const TSubclassOf<UGameplayEffect> ChosenGE = bFromDeactivation ? DeactivationGameplayEffect : ActivationGameplayEffect;
 	const FGameplayTagQuery& ChosenOwnerQuery = bFromDeactivation ? DeactivationOwnerTagQuery : ActivationOwnerTagQuery;
 	const FBlackboardKeySelector& ChosenEffectBlackboardKey = bFromDeactivation ? DeactivationEffectTargetBlackboardKey : ActivationEffectTargetBlackboardKey;
@@ -26,6 +26,7 @@
 #include "AbilitySystem/KaosUtilitiesBlueprintLibrary.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "KaosUtilitiesStats.h"
 
 struct FKaosBTTask_ExecuteGameplayAbilityMemory
 {
@@ -60,6 +61,8 @@ void UKaosBTTask_ExecuteGameplayAbility::InitializeFromAsset(UBehaviorTree& Asse
 
 EBTNodeResult::Type UKaosBTTask_ExecuteGameplayAbility::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
+	KAOS_GAS_SCOPE(BTNode);
+
 	checkSlow(OwnerComp.GetAIOwner() && OwnerComp.GetBlackboardComponent());
 
 	const UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
@@ -0,0 +1,72 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "KaosUtilitiesStats.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_KaosGAS_SpecQuery);
+DEFINE_STAT(STAT_KaosGAS_CanActivate);
+DEFINE_STAT(STAT_KaosGAS_TagRelationships);
+DEFINE_STAT(STAT_KaosGAS_AttributeInit);
+DEFINE_STAT(STAT_KaosGAS_AbilitySetGive);
+DEFINE_STAT(STAT_KaosGAS_AbilitySetRemove);
+DEFINE_STAT(STAT_KaosGAS_GameplayCue);
+DEFINE_STAT(STAT_KaosGAS_BTNode);
+
+DEFINE_STAT(STAT_KaosGAS_NumSpecQuery);
+DEFINE_STAT(STAT_KaosGAS_NumCanActivate);
+DEFINE_STAT(STAT_KaosGAS_NumTagRelationships);
+DEFINE_STAT(STAT_KaosGAS_NumAttributeInit);
+DEFINE_STAT(STAT_KaosGAS_NumAbilitySetGive);
+DEFINE_STAT(STAT_KaosGAS_NumAbilitySetRemove);
+DEFINE_STAT(STAT_KaosGAS_NumGameplayCue);
+DEFINE_STAT(STAT_KaosGAS_NumBTNode);
+
+#if KAOS_GAS_STATS
+
+UE_TRACE_CHANNEL_DEFINE(KaosGASChannel);
+
+bool GKaosGASStatsEnabled = true;
+static FAutoConsoleVariableRef CVarKaosGASStatsEnabled(TEXT("AbilitySystem.Kaos.Stats"), GKaosGASStatsEnabled,
+                                                       TEXT("Enable the KaosGAS stat group counters and timers. The KaosGAS trace scopes follow the KaosGAS trace channel instead"));
+
+static thread_local int32 GKaosGASScopeDepths[static_cast<int32>(EKaosGASScope::Num)] = {};
+
+FKaosGASScopeDepth::FKaosGASScopeDepth(EKaosGASScope InScope)
+	: Scope(InScope)
+	, bEntered(GKaosGASStatsEnabled)
+	, bOutermost(false)
+{
+	// Remember whether we entered so toggling the cvar inside the scope can't unbalance the depth
+	if (bEntered)
+	{
+		bOutermost = GKaosGASScopeDepths[static_cast<int32>(Scope)]++ == 0;
+	}
+}
+
+FKaosGASScopeDepth::~FKaosGASScopeDepth()
+{
+	if (bEntered)
+	{
+		--GKaosGASScopeDepths[static_cast<int32>(Scope)];
+	}
+}
+
+#endif
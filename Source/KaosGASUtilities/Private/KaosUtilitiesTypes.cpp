@@ -21,12 +21,16 @@
 #include "KaosUtilitiesTypes.h"
 
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/KaosAbilitySystemComponent.h"
 #include "KaosUtilitiesLogging.h"
 #include "Logging/StructuredLog.h"
+#include "KaosUtilitiesStats.h"
 
 
 void FKaosAbilitySetHandle::RemoveSet()
 {
+	KAOS_GAS_SCOPE(AbilitySetRemove);
+
 	if (!AbilitySystemComponent->IsOwnerActorAuthoritative())
 	{
 		UE_LOGFMT(LogKaosUtilities, Warning, "Tried to remove set when not authoritive");
@@ -49,9 +53,17 @@ void FKaosAbilitySetHandle::RemoveSet()
 		}
 	}
 
+	UKaosAbilitySystemComponent* KaosAbilitySystemComponent = Cast<UKaosAbilitySystemComponent>(AbilitySystemComponent.Get());
 	for (UAttributeSet* Set : AttributeSets)
 	{
-		AbilitySystemComponent->RemoveSpawnedAttribute(Set);
+		if (KaosAbilitySystemComponent)
+		{
+			KaosAbilitySystemComponent->RemoveAttributeSet(Set);
+		}
+		else
+		{
+			AbilitySystemComponent->RemoveSpawnedAttribute(Set);
+		}
 	}
 
 	UE_LOGFMT(LogKaosUtilities, Log, "Removed ability set with handle {Handle}", HandleId);
@@ -0,0 +1,92 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayAbilitySpecHandle.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "KaosAbilityCooldowns.generated.h"
+
+class UKaosAbilitySystemComponent;
+struct FKaosAbilityCooldownArray;
+
+/** A timestamp cooldown for one ability spec, ends at EndServerTime in the owning world's server time */
+USTRUCT()
+struct KAOSGASUTILITIES_API FKaosAbilityCooldownEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGameplayAbilitySpecHandle Handle;
+
+	/** Kept as a double, server world time loses sub-frame precision as a float after a few hours of uptime */
+	UPROPERTY()
+	double EndServerTime = 0.0;
+
+	UPROPERTY()
+	float Duration = 0.0f;
+
+	void PostReplicatedAdd(const FKaosAbilityCooldownArray& InArraySerializer);
+	void PostReplicatedChange(const FKaosAbilityCooldownArray& InArraySerializer);
+	void PreReplicatedRemove(const FKaosAbilityCooldownArray& InArraySerializer);
+};
+
+/**
+ * Replicated list of timestamp cooldowns on an ability system component. Only entries that are added, changed or removed
+ * are sent, each as a spec handle, an end time and a duration, instead of a full active gameplay effect per cooldown.
+ */
+USTRUCT()
+struct KAOSGASUTILITIES_API FKaosAbilityCooldownArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	/** Adds or refreshes the entry for the handle */
+	void SetCooldown(const FGameplayAbilitySpecHandle& Handle, double EndServerTime, float Duration);
+
+	/** Removes the entry for the handle, returns true if there was one */
+	bool RemoveCooldown(const FGameplayAbilitySpecHandle& Handle);
+
+	/** Removes every entry that ended at or before ServerTime */
+	void RemoveExpired(double ServerTime);
+
+	const FKaosAbilityCooldownEntry* FindCooldown(const FGameplayAbilitySpecHandle& Handle) const;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FKaosAbilityCooldownEntry, FKaosAbilityCooldownArray>(Items, DeltaParms, *this);
+	}
+
+	UPROPERTY()
+	TArray<FKaosAbilityCooldownEntry> Items;
+
+	/** Component that owns this array, receives the replication callbacks */
+	UPROPERTY(NotReplicated)
+	TObjectPtr<UKaosAbilitySystemComponent> Owner = nullptr;
+};
+
+template <>
+struct TStructOpsTypeTraits<FKaosAbilityCooldownArray> : public TStructOpsTypeTraitsBase2<FKaosAbilityCooldownArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,324 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayAbilitySpec.h"
+#include "GameplayTagContainer.h"
+#include "KaosGameplayTagBitSet.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * A tag container resolved once for asking the same question of many components, as the batched library queries do.
+ * The posting list hashes and the tag bitset are worked out here instead of by every component's index.
+ */
+struct KAOSGASUTILITIES_API FKaosResolvedAbilityTags
+{
+	explicit FKaosResolvedAbilityTags(const FGameplayTagContainer& InTags);
+
+	/** The container this was resolved from, it has to outlive the resolved tags */
+	const FGameplayTagContainer& Tags;
+
+	/** GetTypeHash of each tag, in container order, for probing the tag posting lists */
+	TArray<uint32, TInlineAllocator<8>> TagHashes;
+
+	/** The explicit tags as a tag bitset, parents not expanded */
+	FKaosGameplayTagBitSet TagBits;
+
+	/** False if some tag has no net index, so no tag bitset can hold all of them */
+	bool bAllTagsHaveBits = true;
+
+	/** Returns true if the bitset holds every tag, same as FKaosGameplayTagBitSet::HasAllTags(Tags) */
+	bool AreAllTagsIn(const FKaosGameplayTagBitSet& BitSet) const { return bAllTagsHaveBits && BitSet.HasAll(TagBits); }
+};
+
+/**
+ * Lookup tables over an ability system component's granted ability specs.
+ *
+ * The index is kept in sync by the owning UKaosAbilitySystemComponent through OnGiveAbility/OnRemoveAbility, which are
+ * called on the authority when abilities are given or cleared, and on clients when specs are replicated in or out.
+ * Handles are resolved back to specs through a handle to array slot map. Adds record their slot directly, removes only
+ * mark the map stale as the spec array is compacted with RemoveAtSwap after the remove hook has run; the next lookup
+ * then rebuilds it once.
+ */
+struct KAOSGASUTILITIES_API FKaosAbilitySpecIndex
+{
+	/** Adds the spec living at Slot in the spec array to the index. Specs without an ability are only slot mapped. */
+	void AddSpec(const FGameplayAbilitySpec& Spec, int32 Slot);
+
+	/** Removes the spec from the index */
+	void RemoveSpec(const FGameplayAbilitySpecHandle& Handle);
+
+	/** Clears the whole index */
+	void Reset();
+
+	/** Returns true if the spec with the supplied handle is indexed */
+	bool Contains(const FGameplayAbilitySpecHandle& Handle) const { return IndexedSpecs.Contains(Handle); }
+
+	/** Number of indexed specs */
+	int32 Num() const { return SpecHandles.Num(); }
+
+	/** Resolves a handle to its spec in Specs, which must be the array the index is maintained for */
+	FGameplayAbilitySpec* FindSpec(TArray<FGameplayAbilitySpec>& Specs, const FGameplayAbilitySpecHandle& Handle);
+
+#if DO_CHECK
+	/** Asserts the handle to slot map matches Specs. Does nothing while the map is waiting on a rebuild. */
+	void CheckSlotConsistency(const TArray<FGameplayAbilitySpec>& Specs) const;
+#endif
+
+	/**
+	 * Calls Func for every indexed spec handle whose ability tags match ALL of the supplied tags (HasAll semantics, so a
+	 * spec tagged A.B.C matches A.B). Handles are visited in the order the specs sit in Specs, the same order a linear
+	 * scan of the spec array finds them in. Func returns false to stop iterating.
+	 */
+	template <typename FuncType>
+	void ForEachHandleWithAllTags(const TArray<FGameplayAbilitySpec>& Specs, const FGameplayTagContainer& Tags, FuncType&& Func) const;
+
+	/** ForEachHandleWithAllTags for tags resolved up front, the posting lists are found from the precomputed hashes */
+	template <typename FuncType>
+	void ForEachHandleWithAllTags(const TArray<FGameplayAbilitySpec>& Specs, const FKaosResolvedAbilityTags& ResolvedTags, FuncType&& Func) const;
+
+	/**
+	 * Calls Func for every indexed spec handle whose ability tags match the supplied tag, in spec array order.
+	 * Func returns false to stop iterating.
+	 */
+	template <typename FuncType>
+	void ForEachHandleWithTag(const TArray<FGameplayAbilitySpec>& Specs, const FGameplayTag& Tag, FuncType&& Func) const;
+
+	/** Returns the handle of the first spec in Specs for the exact ability class, or an invalid handle */
+	FGameplayAbilitySpecHandle FindHandleByClass(const TArray<FGameplayAbilitySpec>& Specs, const UClass* AbilityClass) const;
+
+	/**
+	 * Returns the handle of the first spec in Specs for the exact ability class and source object, or an invalid handle.
+	 * The source object is captured when the spec is granted, changing FGameplayAbilitySpec::SourceObject afterwards is not tracked.
+	 */
+	FGameplayAbilitySpecHandle FindHandleByClassAndSource(const TArray<FGameplayAbilitySpec>& Specs, const UClass* AbilityClass, const UObject* SourceObject) const;
+
+	/**
+	 * Returns true if any of the spec's cooldown tags is active. Cooldown tags are read from the ability CDO when the spec
+	 * is granted, their state is fed in by the owner through SetCooldownTagActive.
+	 */
+	bool IsOnCooldown(const FGameplayAbilitySpecHandle& Handle) const;
+
+	/** Returns the cooldown tags the spec was indexed with, or null if it is not indexed */
+	const TArray<FGameplayTag>* GetCooldownTags(const FGameplayAbilitySpecHandle& Handle) const;
+
+	/** Returns the spec's ability tags, parents included, as a tag bitset. Null if the spec is not indexed. */
+	const FKaosGameplayTagBitSet* GetAbilityTagBits(const FGameplayAbilitySpecHandle& Handle) const;
+
+	/** Rebuilds every spec's tag bitset from its indexed tags, for when the tag net indices have moved */
+	void RebuildTagBits();
+
+	/** Returns true if some indexed spec uses the tag as a cooldown tag */
+	bool IsCooldownTag(const FGameplayTag& Tag) const { return CooldownTagToSpecHandles.Contains(Tag); }
+
+	/** Updates the cooldown state of every spec using the tag. Returns false if the tag was already in that state. */
+	bool SetCooldownTagActive(const FGameplayTag& Tag, bool bActive);
+
+private:
+	/** What a spec was indexed under, so it can be removed even if the ability or source object is gone */
+	struct FIndexedSpec
+	{
+		TArray<FGameplayTag> Tags;
+		FKaosGameplayTagBitSet TagBits;
+		FObjectKey AbilityClass;
+		FObjectKey SourceObject;
+		TArray<FGameplayTag> CooldownTags;
+
+		/** How many of CooldownTags are currently active, the spec is on cooldown while this is non zero */
+		int32 ActiveCooldownTagCount = 0;
+	};
+
+	using FClassAndSourceKey = TPair<FObjectKey, FObjectKey>;
+
+	void RebuildSlots(const TArray<FGameplayAbilitySpec>& Specs) const;
+
+	/** Slot of the handle in Specs, refreshing the slot map first if it is stale. MAX_int32 if it is not mapped. */
+	int32 GetSlot(const TArray<FGameplayAbilitySpec>& Specs, const FGameplayAbilitySpecHandle& Handle) const;
+
+	/** Calls Func for Handles in spec array order, stopping when it returns false */
+	template <typename FuncType>
+	void ForEachHandleInSlotOrder(const TArray<FGameplayAbilitySpec>& Specs, TConstArrayView<FGameplayAbilitySpecHandle> Handles, FuncType&& Func) const;
+
+	using FPostingLists = TArray<const TArray<FGameplayAbilitySpecHandle>*, TInlineAllocator<8>>;
+
+	/** Calls Func, in spec array order, for every handle that is in all of the posting lists */
+	template <typename FuncType>
+	void ForEachHandleInAllPostingLists(const TArray<FGameplayAbilitySpec>& Specs, const FPostingLists& PostingLists, FuncType&& Func) const;
+
+	/** Calls Func for every indexed spec, in spec array order. What an empty tag container matches. */
+	template <typename FuncType>
+	void ForEachIndexedHandle(const TArray<FGameplayAbilitySpec>& Specs, FuncType&& Func) const;
+
+	/** Returns the handle in Handles that comes first in Specs */
+	FGameplayAbilitySpecHandle FindFirstHandleInSlotOrder(const TArray<FGameplayAbilitySpec>& Specs, const TArray<FGameplayAbilitySpecHandle>* Handles) const;
+
+	/** Ability tag (and every parent of it) to the handles of the specs that have it, in grant order */
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle>> TagToSpecHandles;
+
+	/** Exact ability class to the handles of the specs granted with it, in grant order */
+	TMap<FObjectKey, TArray<FGameplayAbilitySpecHandle>> ClassToSpecHandles;
+
+	/** Exact ability class and source object (at grant time) to the handles of the specs, in grant order */
+	TMap<FClassAndSourceKey, TArray<FGameplayAbilitySpecHandle>> ClassAndSourceToSpecHandles;
+
+	/** Cooldown tag to the handles of the specs whose ability uses it, in grant order */
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle>> CooldownTagToSpecHandles;
+
+	/** Cooldown tags currently present on the owner. Mirrors owner state, so it survives Reset. */
+	TSet<FGameplayTag> ActiveCooldownTags;
+
+	TMap<FGameplayAbilitySpecHandle, FIndexedSpec> IndexedSpecs;
+
+	/** All indexed handles, in grant order */
+	TArray<FGameplayAbilitySpecHandle> SpecHandles;
+
+	/** Handle to index into the spec array, covers every spec with a valid handle. Rebuilt on demand by lookups. */
+	mutable TMap<FGameplayAbilitySpecHandle, int32> HandleToSlot;
+
+	/** Set when a spec was removed, slots of the specs swapped into its place are out of date until rebuilt */
+	mutable bool bSlotsStale = false;
+};
+
+template <typename FuncType>
+void FKaosAbilitySpecIndex::ForEachHandleInSlotOrder(const TArray<FGameplayAbilitySpec>& Specs, TConstArrayView<FGameplayAbilitySpecHandle> Handles, FuncType&& Func) const
+{
+	TArray<TPair<int32, FGameplayAbilitySpecHandle>, TInlineAllocator<16>> SlottedHandles;
+	SlottedHandles.Reserve(Handles.Num());
+	for (const FGameplayAbilitySpecHandle& Handle : Handles)
+	{
+		SlottedHandles.Emplace(GetSlot(Specs, Handle), Handle);
+	}
+	SlottedHandles.Sort([](const TPair<int32, FGameplayAbilitySpecHandle>& A, const TPair<int32, FGameplayAbilitySpecHandle>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	for (const TPair<int32, FGameplayAbilitySpecHandle>& SlottedHandle : SlottedHandles)
+	{
+		if (!Func(SlottedHandle.Value))
+		{
+			return;
+		}
+	}
+}
+
+template <typename FuncType>
+void FKaosAbilitySpecIndex::ForEachIndexedHandle(const TArray<FGameplayAbilitySpec>& Specs, FuncType&& Func) const
+{
+	for (const FGameplayAbilitySpec& Spec : Specs)
+	{
+		if (IndexedSpecs.Contains(Spec.Handle) && !Func(Spec.Handle))
+		{
+			return;
+		}
+	}
+}
+
+template <typename FuncType>
+void FKaosAbilitySpecIndex::ForEachHandleWithAllTags(const TArray<FGameplayAbilitySpec>& Specs, const FGameplayTagContainer& Tags, FuncType&& Func) const
+{
+	// An empty container is matched by every ability, same as FGameplayTagContainer::HasAll
+	if (Tags.IsEmpty())
+	{
+		ForEachIndexedHandle(Specs, Forward<FuncType>(Func));
+		return;
+	}
+
+	FPostingLists PostingLists;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		const TArray<FGameplayAbilitySpecHandle>* Handles = TagToSpecHandles.Find(Tag);
+		if (!Handles)
+		{
+			// Nothing has this tag, so nothing can have all of them
+			return;
+		}
+		PostingLists.Add(Handles);
+	}
+
+	ForEachHandleInAllPostingLists(Specs, PostingLists, Forward<FuncType>(Func));
+}
+
+template <typename FuncType>
+void FKaosAbilitySpecIndex::ForEachHandleWithAllTags(const TArray<FGameplayAbilitySpec>& Specs, const FKaosResolvedAbilityTags& ResolvedTags, FuncType&& Func) const
+{
+	if (ResolvedTags.Tags.IsEmpty())
+	{
+		ForEachIndexedHandle(Specs, Forward<FuncType>(Func));
+		return;
+	}
+
+	FPostingLists PostingLists;
+	int32 TagIdx = 0;
+	for (const FGameplayTag& Tag : ResolvedTags.Tags)
+	{
+		const TArray<FGameplayAbilitySpecHandle>* Handles = TagToSpecHandles.FindByHash(ResolvedTags.TagHashes[TagIdx++], Tag);
+		if (!Handles)
+		{
+			return;
+		}
+		PostingLists.Add(Handles);
+	}
+
+	ForEachHandleInAllPostingLists(Specs, PostingLists, Forward<FuncType>(Func));
+}
+
+template <typename FuncType>
+void FKaosAbilitySpecIndex::ForEachHandleInAllPostingLists(const TArray<FGameplayAbilitySpec>& Specs, const FPostingLists& PostingLists, FuncType&& Func) const
+{
+	// Walk the shortest list and probe the others
+	int32 ShortestIdx = 0;
+	for (int32 Idx = 1; Idx < PostingLists.Num(); ++Idx)
+	{
+		if (PostingLists[Idx]->Num() < PostingLists[ShortestIdx]->Num())
+		{
+			ShortestIdx = Idx;
+		}
+	}
+
+	TArray<FGameplayAbilitySpecHandle, TInlineAllocator<16>> Matches;
+	for (const FGameplayAbilitySpecHandle& Handle : *PostingLists[ShortestIdx])
+	{
+		bool bInAll = true;
+		for (int32 Idx = 0; Idx < PostingLists.Num() && bInAll; ++Idx)
+		{
+			bInAll = Idx == ShortestIdx || PostingLists[Idx]->Contains(Handle);
+		}
+
+		if (bInAll)
+		{
+			Matches.Add(Handle);
+		}
+	}
+
+	// Posting lists are in grant order, callers expect the first match a scan of the spec array would find
+	ForEachHandleInSlotOrder(Specs, Matches, Forward<FuncType>(Func));
+}
+
+template <typename FuncType>
+void FKaosAbilitySpecIndex::ForEachHandleWithTag(const TArray<FGameplayAbilitySpec>& Specs, const FGameplayTag& Tag, FuncType&& Func) const
+{
+	if (const TArray<FGameplayAbilitySpecHandle>* Handles = TagToSpecHandles.Find(Tag))
+	{
+		ForEachHandleInSlotOrder(Specs, *Handles, Forward<FuncType>(Func));
+	}
+}
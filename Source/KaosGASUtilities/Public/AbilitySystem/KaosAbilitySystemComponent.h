@@ -22,6 +22,9 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemComponent.h"
+#include "KaosAbilityCooldowns.h"
+#include "KaosAbilitySpecIndex.h"
+#include "KaosGameplayTagBitSet.h"
 #include "UObject/Object.h"
 #include "KaosAbilitySystemComponent.generated.h"
 
@@ -29,6 +32,34 @@ class UKaosGameplayAbility;
 class UKaosAbilityTagRelationships;
 DECLARE_DELEGATE_OneParam(FKaosOnGiveAbility, FGameplayAbilitySpec&);
 
+/** Result of UKaosAbilitySystemComponent::CanActivateAbilities, one entry per queried tag container */
+struct FKaosCanActivateAbilitiesResult
+{
+	/** Bit per query entry, set if the ability matching that entry can be activated */
+	TBitArray<> CanActivateMask;
+
+	/** Failure tags per query entry, empty for entries that can activate or matched no ability */
+	TArray<FGameplayTagContainer> FailureTags;
+
+	bool CanActivate(int32 EntryIndex) const { return CanActivateMask.IsValidIndex(EntryIndex) && CanActivateMask[EntryIndex]; }
+};
+
+/** An ability activation failure sent to the owning client, with the failure tags as gameplay tag net indices */
+USTRUCT()
+struct FKaosAbilityFailure
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGameplayAbilitySpecHandle Handle;
+
+	/** Sorted, so identical failures compare equal */
+	UPROPERTY()
+	TArray<uint16> FailureTagNetIndices;
+
+	bool operator==(const FKaosAbilityFailure& Other) const { return Handle == Other.Handle && FailureTagNetIndices == Other.FailureTagNetIndices; }
+};
+
 /**
  * 
  */
@@ -38,10 +69,18 @@ class KAOSGASUTILITIES_API UKaosAbilitySystemComponent : public UAbilitySystemCo
 	GENERATED_BODY()
 
 public:
+	UKaosAbilitySystemComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void InitializeComponent() override;
+	virtual void UninitializeComponent() override;
+	virtual void InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor) override;
 	virtual void ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags,
 	                                            const FGameplayTagContainer& CancelTags) override;
 	virtual void NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason) override;
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
 	virtual void NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled) override;
+	virtual void OnRep_SpawnedAttributes(const TArray<UAttributeSet*>& PreviousSpawnedAttributes) override;
 
 	/** Helper function for blueprint to get abilities TargetData */
 	UFUNCTION(BlueprintCallable)
@@ -58,23 +97,94 @@ public:
 	/** Return a mutable pointer to the ActiveGameplayEffect from the supplied handle. */
 	FActiveGameplayEffect* GetActiveGameplayEffect_Mutable(FActiveGameplayEffectHandle Handle);
 
-	/** Returns all active gameplay effect handles */
+	/** Returns all active gameplay effect handles. Prefer ForEachActiveEffect, which does not allocate. */
 	TArray<FActiveGameplayEffectHandle> GetAllActiveEffectHandles() const;
 
+	/**
+	 * Calls Func for every active gameplay effect in place. Func returns false to stop iterating.
+	 * Effects removed by Func are only removed from the container once the visit finishes.
+	 */
+	template <typename FuncType>
+	void ForEachActiveEffect(FuncType&& Func);
+
+	/** Calls Func for every active gameplay effect in place. Func returns false to stop iterating. */
+	template <typename FuncType>
+	void ForEachActiveEffect(FuncType&& Func) const;
+
+	/** ForEachActiveEffect, only visiting the effects that match Query */
+	template <typename FuncType>
+	void ForEachActiveEffectMatchingQuery(const FGameplayEffectQuery& Query, FuncType&& Func);
+
+	/** ForEachActiveEffect, only visiting the effects that match Query */
+	template <typename FuncType>
+	void ForEachActiveEffectMatchingQuery(const FGameplayEffectQuery& Query, FuncType&& Func) const;
+
+	/**
+	 * Calls Func for every granted spec with an ability, in place under the ability list lock. Func returns false to stop
+	 * iterating. Abilities cleared by Func are only removed once the visit finishes.
+	 */
+	template <typename FuncType>
+	void ForEachSpec(FuncType&& Func);
+
+	/** Returns the first granted spec with an ability that Predicate returns true for, or null */
+	template <typename PredicateType>
+	FGameplayAbilitySpec* FindFirstSpec(PredicateType&& Predicate);
+
+	/** Returns how many granted specs with an ability Predicate returns true for */
+	template <typename PredicateType>
+	int32 CountSpecs(PredicateType&& Predicate);
+
 	/** Accessor for the OnGiveAbility delegate */
 	FKaosOnGiveAbility& GetKaosOnGiveAbilityDelegate() { return KaosOnGiveAbility; }
 
+	/** Returns false if any additive modifier of the spec would take its attribute below zero */
 	virtual bool CanApplyAttributeModifiers(FGameplayEffectSpec EffectSpec);
 
+	/**
+	 * CanApplyAttributeModifiers without copying the spec, only the additive modifier magnitudes are calculated. Does not
+	 * go through the virtual, callers that need to respect overrides of it should call that instead.
+	 */
+	bool CanApplyEffectSpecModifiers(const FGameplayEffectSpec& EffectSpec) const;
+
+	/** CanApplyEffectSpecModifiers for any ability system component */
+	static bool CanAbilitySystemApplyAttributeModifiers(const UAbilitySystemComponent& AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec);
+
 	/** Marks the ActiveGameplayEffect as dirty for replication purposes */
 	void MarkActiveGameplayEffectDirty(FActiveGameplayEffect* ActiveGE);
 
 	/** Checks the active effect duration and runs any logic, checks to see if the GE is expired and removes it. */
 	void CheckActiveEffectDuration(const FActiveGameplayEffectHandle& Handle);
 	
-	/** Returns the relationship for activation requirements from the supplied ability tags */
+	/**
+	 * Returns the relationship for activation requirements from the supplied ability tags. UKaosGameplayAbility calls this
+	 * when UsesOwnedTagBits is false, VisitRelationshipActivationTagBits otherwise.
+	 */
 	virtual void GetRelationshipActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const;
 
+	/**
+	 * Calls Func with the activation required and blocked tags for the supplied ability tags as tag bitsets, once per
+	 * set of requirements. UKaosGameplayAbility tests them against GetOwnedTagBits when UsesOwnedTagBits is true. The
+	 * default only calls Func if there is a relationship asset, overrides may call it any number of times (see
+	 * FKaosGameplayTagBitSet::FromContainer).
+	 */
+	virtual void VisitRelationshipActivationTagBits(const FGameplayTagContainer& AbilityTags, TFunctionRef<void(const FKaosGameplayTagBitSet& RequiredTagBits, const FKaosGameplayTagBitSet& BlockedTagBits)> Func) const;
+
+	/**
+	 * Owned gameplay tags, parents included, as a tag bitset. Kept in sync with the owned tag counts through the generic
+	 * tag event. Subclasses whose GetOwnedGameplayTags adds tags from elsewhere must call RebuildOwnedTagBits whenever
+	 * those change.
+	 */
+	const FKaosGameplayTagBitSet& GetOwnedTagBits() const { return OwnedTagBits; }
+
+	/**
+	 * Whether UKaosGameplayAbility may check activation requirements against GetOwnedTagBits and
+	 * VisitRelationshipActivationTagBits instead of GetOwnedGameplayTags and GetRelationshipActivationTagRequirements.
+	 * True for this class and its blueprint subclasses, which can't override either. Native subclasses get the container
+	 * path so their overrides keep working, override this to return true once they keep the bits in sync (see
+	 * RebuildOwnedTagBits) and implement the bitset hook.
+	 */
+	virtual bool UsesOwnedTagBits() const;
+
 	/** Can we activate this ability with the supplied class */
 	UFUNCTION(BlueprintCallable)
 	bool CanActivateAbilityByClass(TSubclassOf<UGameplayAbility> AbilityClass, FGameplayTagContainer& OutFailureTags);
@@ -96,64 +206,388 @@ public:
 
 	/** Do we have an activate ability with any matching tags */
 	UFUNCTION(BlueprintCallable)
-	bool HasActiveAbilityWithAnyMatchingTag(const FGameplayTagContainer GameplayAbilityTags);
+	bool HasActiveAbilityWithAnyMatchingTag(const FGameplayTagContainer& GameplayAbilityTags);
 
 	/** Do we have an activate ability with all matching tags */
 	UFUNCTION(BlueprintCallable)
-	bool HasActiveAbilityWithAllMatchingTag(const FGameplayTagContainer GameplayAbilityTags);
+	bool HasActiveAbilityWithAllMatchingTag(const FGameplayTagContainer& GameplayAbilityTags);
+
+	/** HasActiveAbilityWithAllMatchingTag for tags resolved once across many components */
+	bool HasActiveAbilityWithAllMatchingTag(const FKaosResolvedAbilityTags& ResolvedTags);
 
 	/** Can we activate an ability with any matching tags */
 	UFUNCTION(BlueprintCallable)
-	bool CanActivateAbilityWithAnyMatchingTag(const FGameplayTagContainer GameplayAbilityTags);
+	bool CanActivateAbilityWithAnyMatchingTag(const FGameplayTagContainer& GameplayAbilityTags);
 
 	/** Can we activate an ability with all matching tags */
 	UFUNCTION(BlueprintCallable)
-	bool CanActivateAbilityWithAllMatchingTag(const FGameplayTagContainer GameplayAbilityTags);
+	bool CanActivateAbilityWithAllMatchingTag(const FGameplayTagContainer& GameplayAbilityTags);
 
-	/** Do we have this attribute set? */
+	/** Do we have this attribute set? A set lookup on the classes, and their super classes, of the spawned attribute sets. */
 	UFUNCTION(BlueprintCallable)
 	bool HasAttributeSet(TSubclassOf<UAttributeSet> AttributeClass) const;
 
+	/** AddSpawnedAttribute that keeps the HasAttributeSet lookup up to date as it goes */
+	void AddAttributeSet(UAttributeSet* Attribute);
+
+	/** RemoveSpawnedAttribute that keeps the HasAttributeSet lookup up to date as it goes */
+	void RemoveAttributeSet(UAttributeSet* Attribute);
+
 	/** Do we have this attribute set? */
 	UFUNCTION(BlueprintCallable)
 	bool IsAbilityTagBlocked(FGameplayTag AbilityTag);
 
 	/** Cancel abilitiy with all the supplied tags */
 	UFUNCTION(BlueprintCallable)
-	void CancelAbilityWithAllTags(const FGameplayTagContainer GameplayAbilityTags);
+	void CancelAbilityWithAllTags(const FGameplayTagContainer& GameplayAbilityTags);
+
+	/**
+	 * Cancel active abilities matching all the tags of any of the supplied containers. Every match is collected before the
+	 * first cancel, then all of them are cancelled in one pass.
+	 */
+	void CancelAbilitiesWithAllTags(TConstArrayView<FGameplayTagContainer> GameplayAbilityTagGroups);
+
+	/** Cancel active abilities matching all the tags of any of the supplied containers */
+	UFUNCTION(BlueprintCallable, DisplayName = "Cancel Abilities With All Tags")
+	void K2_CancelAbilitiesWithAllTags(const TArray<FGameplayTagContainer>& GameplayAbilityTagGroups);
 
 	/** Is ability on cooldown with all the tags */
 	UFUNCTION(BlueprintCallable)
-	bool IsAbilityOnCooldownWithAllTags(const FGameplayTagContainer GameplayAbilityTags);
+	bool IsAbilityOnCooldownWithAllTags(const FGameplayTagContainer& GameplayAbilityTags);
+
+	/** IsAbilityOnCooldownWithAllTags for tags resolved once across many components */
+	bool IsAbilityOnCooldownWithAllTags(const FKaosResolvedAbilityTags& ResolvedTags);
+
+	/** Is the ability with the supplied handle on cooldown */
+	bool IsAbilityOnCooldown(const FGameplayAbilitySpecHandle& Handle) const { return AbilitySpecIndex.IsOnCooldown(Handle) || IsTimestampCooldownActive(Handle); }
+
+	/**
+	 * Starts or restarts a timestamp cooldown for the spec. The authority replicates it to the owner, a predicting client
+	 * applies it locally until the server's copy arrives. The ability's cooldown tags are added as loose tags while it runs.
+	 */
+	void StartTimestampCooldown(const FGameplayAbilitySpecHandle& Handle, float Duration);
+
+	/** Ends the spec's timestamp cooldown early */
+	void ClearTimestampCooldown(const FGameplayAbilitySpecHandle& Handle);
+
+	/** Is the spec on a timestamp cooldown */
+	bool IsTimestampCooldownActive(const FGameplayAbilitySpecHandle& Handle) const;
+
+	/** Returns false if the spec is not on a timestamp cooldown */
+	bool GetTimestampCooldownTimeRemaining(const FGameplayAbilitySpecHandle& Handle, float& TimeRemaining, float& Duration) const;
+
+	/** Server world time timestamp cooldowns are measured in */
+	double GetTimestampCooldownServerTime() const;
+
+	/**
+	 * Gets the longest time remaining, and its duration, over the active gameplay effects granting any of the cooldown
+	 * tags. Infinite effects report -1 for both. Returns false if no such effect is active.
+	 * Cooldown tags of granted abilities are answered from a per tag cache, other tags query the active effects.
+	 */
+	bool GetCooldownTimeRemainingForTags(const FGameplayTagContainer& CooldownTags, float& TimeRemaining, float& Duration) const;
+
+	/** Called by the replicated cooldown array */
+	void OnTimestampCooldownReplicated(const FKaosAbilityCooldownEntry& Entry);
+	void OnTimestampCooldownRemoved(const FGameplayAbilitySpecHandle& Handle);
 
 	/** Have we got this ability with all the supplied tags */
 	UFUNCTION(BlueprintCallable)
-	bool HasAbilityWithAllTags(const FGameplayTagContainer GameplayAbilityTags);
+	bool HasAbilityWithAllTags(const FGameplayTagContainer& GameplayAbilityTags);
+
+	/** HasAbilityWithAllTags for tags resolved once across many components */
+	bool HasAbilityWithAllTags(const FKaosResolvedAbilityTags& ResolvedTags);
 
 	/** Can we activate the ability with all the supplied matching tags */
 	UFUNCTION(BlueprintCallable)
-	bool CanActivateAbilityWithAllMatchingTags(const FGameplayTagContainer GameplayAbilityTags, FGameplayTagContainer& OutFailureTags);
+	bool CanActivateAbilityWithAllMatchingTags(const FGameplayTagContainer& GameplayAbilityTags, FGameplayTagContainer& OutFailureTags);
+
+	/** CanActivateAbilityWithAllMatchingTags for tags resolved once across many components */
+	bool CanActivateAbilityWithAllMatchingTags(const FKaosResolvedAbilityTags& ResolvedTags, FGameplayTagContainer& OutFailureTags);
+
+	/**
+	 * Batched CanActivateAbilityWithAllMatchingTags. Each entry resolves to the same ability the single query would, the
+	 * owned tags are tested through the owned tag bitset and each matched ability is only checked once.
+	 */
+	FKaosCanActivateAbilitiesResult CanActivateAbilities(TConstArrayView<FGameplayTagContainer> GameplayAbilityTags);
+
+	/**
+	 * Drops every cached CanActivateAbility result. The cache tracks owned tags, blocked ability tags, gameplay effects,
+	 * cost attributes, the spec list, activations and actor info. Call this when anything else a check depends on
+	 * changes, such as ability levels, additional costs or blueprint CanActivateAbility logic.
+	 */
+	void InvalidateCanActivateAbilityCache() { ++CanActivateAbilityGeneration; }
 
 protected:
-	
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
 	FGameplayAbilitySpec* FindAbilitySpecFromTag(FGameplayTag Tag);
 	FGameplayAbilitySpec* FindAbilitySpecByClassAndSource(TSubclassOf<UGameplayAbility> AbilityClass, UObject* SourceObject);
 
+	/** Returns the first spec in ActivatableAbilities whose ability has all the supplied tags, using the spec index */
+	FGameplayAbilitySpec* FindAbilitySpecWithAllTags(const FGameplayTagContainer& GameplayAbilityTags);
+	FGameplayAbilitySpec* FindAbilitySpecWithAllTags(const FKaosResolvedAbilityTags& ResolvedTags);
+
+	/** Resolves a handle from the spec index back to the live spec */
+	FGameplayAbilitySpec* FindIndexedAbilitySpec(const FGameplayAbilitySpecHandle& Handle);
+
+	/** Runs CanActivateAbility on Ability for the spec, reusing the cached result when bCacheCanActivateAbilityResults is set */
+	bool CheckCanActivateAbility(const FGameplayAbilitySpec& Spec, const UGameplayAbility* Ability, FGameplayTagContainer* OutFailureTags);
+
+	/** Listens for changes to the attributes the ability's cost effect modifies */
+	void BindCostAttributesForCanActivateCache(const UGameplayAbility* Ability);
+
+	void ApplyLocalTimestampCooldown(const FGameplayAbilitySpecHandle& Handle, double EndServerTime, float Duration);
+	void RemoveLocalTimestampCooldown(const FGameplayAbilitySpecHandle& Handle);
+
+	/** Sets the expiry timer to the earliest running timestamp cooldown */
+	void ScheduleTimestampCooldownExpiry();
+	void HandleTimestampCooldownsExpired();
+
+	/** Starts tracking the spec's cooldown tags on the owner so the spec index knows when it is on cooldown */
+	void TrackCooldownTags(const FGameplayAbilitySpec& AbilitySpec);
+
+	void HandleCooldownTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void HandleCooldownEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle);
+
+	/** Bound on effects granting a tracked cooldown tag, catches ModifyActiveEffectStartTime and duration changes */
+	void HandleCooldownEffectTimeChanged(FActiveGameplayEffectHandle ActiveHandle, float NewStartTime, float NewDuration);
+
+	/** Removes the cached timing of every tag in GrantedTags */
+	void DropCooldownTagTimings(const FGameplayTagContainer& GrantedTags);
+
+	struct FKaosCooldownTagTiming
+	{
+		/** World time the longest effect granting the tag ends, negative for an infinite effect */
+		float EndTime = 0.0f;
+		float Duration = 0.0f;
+
+		/** False if the tag is only present without an effect granting it, such as a loose or timestamp cooldown tag */
+		bool bHasEffect = false;
+	};
+
+	/** Returns the cached timing for a tracked cooldown tag, querying the active effects if it is missing or has run out */
+	const FKaosCooldownTagTiming& FindOrAddCooldownTagTiming(const FGameplayTag& Tag, float WorldTime) const;
+
+	/** Adds or removes one set worth of its class and super classes to AttributeSetClassCounts */
+	void CountAttributeSetClasses(const UAttributeSet* Set, int32 Delta) const;
+
+	/** Recounts AttributeSetClassCounts from the spawned attribute sets */
+	void RebuildAttributeSetClasses() const;
+
+	void HandleCanActivateTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void HandleOwnedTagBitChanged(const FGameplayTag Tag, int32 NewCount);
+	void HandleCanActivateEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle);
+	void HandleCanActivateEffectRemoved(const FActiveGameplayEffect& EffectRemoved);
+	void HandleCanActivateAttributeChanged(const FOnAttributeChangeData& ChangeData);
+
+	/** Adds or removes one activation worth of the ability's tags (and their parents) to the active ability tag bits */
+	void UpdateActiveAbilityTags(const FGameplayAbilitySpecHandle& Handle, const UGameplayAbility* Ability, bool bActivated);
+
+	/** Rebuilds OwnedTagBits from GetOwnedGameplayTags */
+	void RebuildOwnedTagBits();
+
+	/**
+	 * Rebuilds every tag bitset keyed by tag net index, the owned, active ability and spec index ones. Bound to
+	 * OnGameplayTagTreeChanged and, in the editor, OnEditorRefreshGameplayTagTree.
+	 */
+	void RebuildTagBits();
 	
 	//Returns the ability tag relationship data asset, overridable by game's to provide a different a different asset to the default ASC one
 	virtual const UKaosAbilityTagRelationships* GetAbilityTagRelationships() const;
 
 	/** Notify client that an ability failed to activate */
+	UE_DEPRECATED(5.3, "NotifyAbilityFailed now batches failures into ClientNotifyAbilitiesFailed, queue them there instead.")
 	UFUNCTION(Client, Unreliable)
 	void ClientNotifyAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason);
 
+	/** Notify client of the abilities that failed to activate this frame */
+	UFUNCTION(Client, Unreliable)
+	void ClientNotifyAbilitiesFailed(const TArray<FKaosAbilityFailure>& Failures);
+
+	/** Sends the failures queued this frame in one ClientNotifyAbilitiesFailed */
+	void FlushAbilityFailures();
+
+	/** Queues an ended remove after activation ability to be cleared by FlushPendingAbilityRemovals, marking it pending remove so it can't activate again meanwhile */
+	void QueueAbilityRemoval(const FGameplayAbilitySpecHandle& Handle);
+
+	/** Clears every queued ability with one compaction of the spec array and one dirty mark, skipping any still active (they queue again when they end) */
+	void FlushPendingAbilityRemovals();
+
 	/** Notify the ability it failed */
 	virtual void HandleAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason);
 
 	/** Callback when an ability is given */
 	FKaosOnGiveAbility KaosOnGiveAbility;
 
+	/** Lookup tables over ActivatableAbilities, maintained by OnGiveAbility/OnRemoveAbility */
+	FKaosAbilitySpecIndex AbilitySpecIndex;
+
+	/** Bit per gameplay tag net index, set while any active ability has the tag or a child of it */
+	FKaosGameplayTagBitSet ActiveAbilityTagBits;
+
+	/** See GetOwnedTagBits */
+	FKaosGameplayTagBitSet OwnedTagBits;
+
+	/** Number of running activations holding each bit in ActiveAbilityTagBits */
+	TArray<uint16> ActiveAbilityTagCounts;
+
+	/** Activations each spec currently has counted in ActiveAbilityTagBits, so removed specs can be backed out */
+	TMap<FGameplayAbilitySpecHandle, int32> ActiveAbilityTagActivations;
+
+	/** Timestamp cooldowns started on the authority, replicated to the owner */
+	UPROPERTY(Replicated)
+	FKaosAbilityCooldownArray TimestampCooldowns;
+
+	struct FKaosLocalTimestampCooldown
+	{
+		double EndServerTime = 0.0;
+		float Duration = 0.0f;
+
+		/** Loose tags added for this cooldown */
+		FGameplayTagContainer CooldownTags;
+	};
+
+	/** Timestamp cooldowns running on this machine, authoritative, replicated or predicted */
+	TMap<FGameplayAbilitySpecHandle, FKaosLocalTimestampCooldown> LocalTimestampCooldowns;
+
+	FTimerHandle TimestampCooldownTimerHandle;
+
+	/** Remove after activation abilities waiting for FlushPendingAbilityRemovals */
+	TArray<FGameplayAbilitySpecHandle> PendingAbilityRemovals;
+
+	/** Failures waiting for FlushAbilityFailures, duplicates are dropped as they are queued */
+	TArray<FKaosAbilityFailure> PendingAbilityFailures;
+
+	/** Cooldown tags with a tag event bound to HandleCooldownTagChanged */
+	TSet<FGameplayTag> TrackedCooldownTags;
+
+	/**
+	 * Timing of the effects granting each tracked cooldown tag. Entries are dropped when the tag count changes or an effect
+	 * granting the tag is applied again (stack refresh), and rebuilt by the next query.
+	 */
+	mutable TMap<FGameplayTag, FKaosCooldownTagTiming> CooldownTagTimings;
+
+	/**
+	 * Number of spawned attribute sets of each class, counting every super class down to UAttributeSet. Maintained by
+	 * AddAttributeSet/RemoveAttributeSet and rebuilt on InitializeComponent and OnRep_SpawnedAttributes. Sets added
+	 * with the non virtual AddSpawnedAttribute directly are picked up when the set count stops matching
+	 * NumCountedAttributeSets, prefer the Kaos functions so a remove and add between queries can't slip through.
+	 */
+	mutable TMap<FObjectKey, int32> AttributeSetClassCounts;
+	mutable int32 NumCountedAttributeSets = 0;
+
+	/**
+	 * Remember CanActivateAbility results for the ability queries on this component until something they depend on
+	 * changes. Only the query helpers use the cache, activation always runs the full check.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Abilities")
+	bool bCacheCanActivateAbilityResults = false;
+
+	struct FKaosCachedCanActivateAbility
+	{
+		uint32 Generation = 0;
+		const UGameplayAbility* Ability = nullptr;
+		bool bCanActivate = false;
+		FGameplayTagContainer FailureTags;
+	};
+
+	/** Bumped whenever anything a cached CanActivateAbility result depends on changes */
+	uint32 CanActivateAbilityGeneration = 1;
+
+	TMap<FGameplayAbilitySpecHandle, FKaosCachedCanActivateAbility> CanActivateAbilityCache;
+
+	/** Cost attributes already bound to HandleCanActivateAttributeChanged */
+	TSet<FGameplayAttribute> CanActivateCostAttributes;
+
 	//Mapping of abilities tags to block and cancel tags. Can be overriden using GetAbilityTagRelationships()
 	UPROPERTY(EditDefaultsOnly, Category = "Relationship")
 	TObjectPtr<UKaosAbilityTagRelationships> AbilityTagRelationship;
 };
+
+template <typename FuncType>
+void UKaosAbilitySystemComponent::ForEachActiveEffect(FuncType&& Func)
+{
+	// Defers removals made by Func so the iterator stays valid
+	FScopedActiveGameplayEffectLock ActiveScopeLock(ActiveGameplayEffects);
+
+	for (auto It = ActiveGameplayEffects.CreateIterator(); It; ++It)
+	{
+		if (!Func(*It))
+		{
+			return;
+		}
+	}
+}
+
+template <typename FuncType>
+void UKaosAbilitySystemComponent::ForEachActiveEffect(FuncType&& Func) const
+{
+	for (auto It = ActiveGameplayEffects.CreateConstIterator(); It; ++It)
+	{
+		if (!Func(*It))
+		{
+			return;
+		}
+	}
+}
+
+template <typename FuncType>
+void UKaosAbilitySystemComponent::ForEachActiveEffectMatchingQuery(const FGameplayEffectQuery& Query, FuncType&& Func)
+{
+	ForEachActiveEffect([&Query, &Func](FActiveGameplayEffect& ActiveEffect)
+	{
+		return !Query.Matches(ActiveEffect) || Func(ActiveEffect);
+	});
+}
+
+template <typename FuncType>
+void UKaosAbilitySystemComponent::ForEachActiveEffectMatchingQuery(const FGameplayEffectQuery& Query, FuncType&& Func) const
+{
+	ForEachActiveEffect([&Query, &Func](const FActiveGameplayEffect& ActiveEffect)
+	{
+		return !Query.Matches(ActiveEffect) || Func(ActiveEffect);
+	});
+}
+
+template <typename FuncType>
+void UKaosAbilitySystemComponent::ForEachSpec(FuncType&& Func)
+{
+	ABILITYLIST_SCOPE_LOCK();
+
+	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		if (Spec.Ability && !Func(Spec))
+		{
+			return;
+		}
+	}
+}
+
+template <typename PredicateType>
+FGameplayAbilitySpec* UKaosAbilitySystemComponent::FindFirstSpec(PredicateType&& Predicate)
+{
+	FGameplayAbilitySpec* FoundSpec = nullptr;
+	ForEachSpec([&Predicate, &FoundSpec](FGameplayAbilitySpec& Spec)
+	{
+		if (Predicate(Spec))
+		{
+			FoundSpec = &Spec;
+			return false;
+		}
+		return true;
+	});
+	return FoundSpec;
+}
+
+template <typename PredicateType>
+int32 UKaosAbilitySystemComponent::CountSpecs(PredicateType&& Predicate)
+{
+	int32 Count = 0;
+	ForEachSpec([&Predicate, &Count](FGameplayAbilitySpec& Spec)
+	{
+		Count += Predicate(Spec) ? 1 : 0;
+		return true;
+	});
+	return Count;
+}
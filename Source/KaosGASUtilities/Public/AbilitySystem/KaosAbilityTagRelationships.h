@@ -22,7 +22,10 @@
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
+#include "KaosGameplayTagBitSet.h"
+#include "Misc/ScopeRWLock.h"
 #include "UObject/Object.h"
+#include "UObject/ObjectSaveContext.h"
 #include "KaosAbilityTagRelationships.generated.h"
 
 /***********
@@ -31,7 +34,8 @@
  * Add the following to your custom subclass of UAbilitySystemComponent
  * 
  * public:
- *	void GetRelationshipActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const;
+ *	virtual bool UsesOwnedTagBits() const override { return true; }
+ *	virtual void VisitRelationshipActivationTagBits(const FGameplayTagContainer& AbilityTags, TFunctionRef<void(const FKaosGameplayTagBitSet& RequiredTagBits, const FKaosGameplayTagBitSet& BlockedTagBits)> Func) const override;
  * protected:
  *	
  *	UPROPERTY(EditDefaultsOnly, Category = "Abilities|GameplayTags")
@@ -64,6 +68,84 @@ struct FKaosAbilityTagRelationship
 	FGameplayTagContainer ActivationBlockedTags;
 };
 
+/** Relationships that apply to an ability tag, merged from every entry for that tag or one of its parents */
+struct FKaosCompiledAbilityTagRelationship
+{
+	FGameplayTagContainer AbilityTagsToBlock;
+	FGameplayTagContainer AbilityTagsToCancel;
+	FGameplayTagContainer ActivationRequiredTags;
+	FGameplayTagContainer ActivationBlockedTags;
+
+	/** The cancel and activation containers as tag bitsets, exact tags only */
+	FKaosGameplayTagBitSet AbilityTagsToCancelBits;
+	FKaosGameplayTagBitSet ActivationRequiredTagBits;
+	FKaosGameplayTagBitSet ActivationBlockedTagBits;
+};
+
+/**
+ * Compiled form of the relationships in flat arrays keyed by tag net index. Cooked assets carry it so loading does not
+ * have to compile, it is read in place and only valid for the tag table it was compiled against.
+ */
+struct FKaosAbilityTagRelationshipBlob
+{
+	/** Tag lists stored per ability tag */
+	enum EList : int32
+	{
+		TagsToBlock,
+		TagsToCancel,
+		RequiredTags,
+		BlockedTags,
+		NumLists
+	};
+
+	/** Tag bitsets stored per ability tag */
+	enum EBitSet : int32
+	{
+		CancelBits,
+		RequiredBits,
+		BlockedBits,
+		NumBitSets
+	};
+
+	/** UGameplayTagsManager::GetNetworkGameplayTagNodeIndexHash of the tag table the indices refer to */
+	uint32 TagTableHash = 0;
+
+	/** Net index of every ability tag with relationships, sorted. Entry N owns lists and bitsets N * NumLists/NumBitSets onwards. */
+	TArray<uint16> AbilityTagIndices;
+
+	/** Start of each list in ListTagIndices, with a trailing end offset */
+	TArray<int32> ListOffsets;
+	TArray<uint16> ListTagIndices;
+
+	/** Start of each ability tag bitset in Words, with a trailing end offset */
+	TArray<int32> BitSetOffsets;
+
+	/** Net index of every relationship tag, sorted, each with the bitset of ability tags it cancels */
+	TArray<uint16> ActionTagIndices;
+
+	/** Start of each action tag bitset in Words, with a trailing end offset */
+	TArray<int32> ActionBitSetOffsets;
+
+	/** Words of every bitset */
+	TArray<uint64> Words;
+
+	/** Entry of the ability tag, INDEX_NONE if it has no relationships */
+	int32 FindAbilityTag(int32 TagIndex) const { return FindTagIndex(AbilityTagIndices, TagIndex); }
+	TConstArrayView<uint16> GetList(int32 Entry, EList List) const;
+	TConstArrayView<uint64> GetBitSet(int32 Entry, EBitSet BitSet) const;
+
+	/** Entry of the relationship tag, INDEX_NONE if there is no relationship for it */
+	int32 FindActionTag(int32 TagIndex) const { return FindTagIndex(ActionTagIndices, TagIndex); }
+	TConstArrayView<uint64> GetActionBitSet(int32 Entry) const;
+
+	void Reset();
+
+	friend FArchive& operator<<(FArchive& Ar, FKaosAbilityTagRelationshipBlob& Blob);
+
+private:
+	static int32 FindTagIndex(const TArray<uint16>& SortedTagIndices, int32 TagIndex);
+};
+
 /**
  * 
  */
@@ -77,13 +159,73 @@ private:
 	UPROPERTY(EditAnywhere, Category = Ability, meta=(TitleProperty="AbilityTag"))
 	TArray<FKaosAbilityTagRelationship> AbilityTagRelationships;
 
+	/**
+	 * AbilityTagRelationships merged per ability tag, an entry applies to its tag and every child of it. Also holds the
+	 * reverse index for IsAbilityCancelledByTag, relationship tag to every AbilityTagsToCancel tag with its parents, as
+	 * an ability having any of them is cancelled.
+	 */
+	FKaosAbilityTagRelationshipBlob CompiledRelationships;
+
+	/** Set when CompiledRelationships was loaded from a cooked package */
+	bool bHasBakedRelationships = false;
+
+	/** Relationships resolved for a whole ability tag container */
+	struct FResolvedRelationships
+	{
+		FGameplayTagContainer AbilityTags;
+		FKaosCompiledAbilityTagRelationship Relationships;
+	};
+
+	/**
+	 * Resolved relationships keyed by the hash of the ability tag container, the same containers are resolved on every
+	 * activation, end and CanActivate. Bounded, cleared whenever the relationships are compiled. Guarded by
+	 * ResolvedRelationshipsLock as abilities can be checked off the game thread.
+	 */
+	mutable TMap<uint32, FResolvedRelationships> ResolvedRelationships;
+	mutable FRWLock ResolvedRelationshipsLock;
+
+	/** Rebuilds the compiled lookups from AbilityTagRelationships */
+	void CompileRelationships();
+
+	/** Calls Func with the relationships resolved for AbilityTags, from ResolvedRelationships when possible */
+	template <typename FuncType>
+	void VisitResolvedRelationships(const FGameplayTagContainer& AbilityTags, FuncType&& Func) const;
+
 public:
+	//~ Begin UObject Interface
+	virtual void PostInitProperties() override;
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+	virtual void BeginDestroy() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
+#endif
+	//~ End UObject Interface
+
 	/** Given a set of ability tags, parse the tag relationship and fill out tags to block and cancel */
 	void GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const;
 
 	/** Given a set of ability tags, add additional required and blocking tags */
 	void GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const;
 
+	/** Tag bitset version of GetAbilityTagsToBlockAndCancel, the cancel tags are ORed into OutTagsToCancel */
+	void GetAbilityTagsToBlockAndCancelBits(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FKaosGameplayTagBitSet* OutTagsToCancel) const;
+
+	/**
+	 * Calls Func with the activation required and blocked tags for a set of ability tags as tag bitsets, without copying
+	 * them. Test them against an owned tag bitset built with parents expanded.
+	 */
+	void VisitActivationTagBits(const FGameplayTagContainer& AbilityTags, TFunctionRef<void(const FKaosGameplayTagBitSet& RequiredTagBits, const FKaosGameplayTagBitSet& BlockedTagBits)> Func) const;
+
 	/** Returns true if the specified ability tags are canceled by the passed in action tag */
 	bool IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const;
+
+	/**
+	 * IsAbilityCancelledByTag for ability tags already in a tag bitset, built from the explicit ability tags without their
+	 * parents. For callers asking every frame, the check is then a single lookup and bitset intersect.
+	 */
+	bool IsAbilityCancelledByTag(const FKaosGameplayTagBitSet& AbilityTagBits, const FGameplayTag& ActionTag) const;
 };
@@ -22,11 +22,23 @@
 
 #include "CoreMinimal.h"
 #include "Abilities/GameplayAbility.h"
+#include "ScalableFloat.h"
 #include "UObject/Object.h"
 #include "KaosGameplayAbility.generated.h"
 
 class UKaosAbilityCosts;
 
+/** How a Kaos ability tracks its cooldown */
+UENUM(BlueprintType)
+enum class EKaosAbilityCooldownMode : uint8
+{
+	/** The cooldown gameplay effect is applied to the owner */
+	GameplayEffect,
+
+	/** An end timestamp is stored on the Kaos ability system component, no gameplay effect is applied */
+	Timestamp
+};
+
 /**
  * 
  */
@@ -49,6 +61,10 @@ public:
 	virtual void OnRemoveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	virtual void ApplyCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const override;
 	virtual bool CheckCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
+	virtual const FGameplayTagContainer* GetCooldownTags() const override;
+	virtual bool CheckCooldown(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
+	virtual void ApplyCooldown(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const override;
+	virtual void GetCooldownTimeRemainingAndDuration(FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, float& TimeRemaining, float& CooldownDuration) const override;
 
 	/** Returns the cooldown tags for this ability */
 	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Cooldown Tags"), Category=Ability)
@@ -125,6 +141,18 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Costs)
 	bool bOnlyApplyCostOnHit;
 
+	/** How the cooldown is tracked. Timestamp cooldowns are cheaper for frequently used abilities and need a UKaosAbilitySystemComponent. */
+	UPROPERTY(EditDefaultsOnly, Category = Cooldowns)
+	EKaosAbilityCooldownMode CooldownMode = EKaosAbilityCooldownMode::GameplayEffect;
+
+	/** Length of the timestamp cooldown in seconds */
+	UPROPERTY(EditDefaultsOnly, Category = Cooldowns, meta = (EditCondition = "CooldownMode == EKaosAbilityCooldownMode::Timestamp", EditConditionHides))
+	FScalableFloat TimestampCooldownDuration;
+
+	/** Added to the owner as loose tags while the timestamp cooldown runs, so tag based cooldown queries see it */
+	UPROPERTY(EditDefaultsOnly, Category = Cooldowns, meta = (EditCondition = "CooldownMode == EKaosAbilityCooldownMode::Timestamp", EditConditionHides))
+	FGameplayTagContainer TimestampCooldownTags;
+
 	/** Called when this ability is granted to the ability system component. */
 	UFUNCTION(BlueprintImplementableEvent, Category = Ability, DisplayName = "On Ability Added")
 	void K2_OnAbilityAdded();
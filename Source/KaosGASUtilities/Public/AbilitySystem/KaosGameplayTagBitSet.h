@@ -0,0 +1,92 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * Set of gameplay tags stored as one bit per tag, indexed by the tag's replication net index.
+ *
+ * Unlike FGameplayTagContainer a bitset has no implicit parent matching, bits are compared exactly. To get the usual
+ * HasAll/HasAny semantics the set being tested (owned tags, ability tags) is built with its parents expanded and the
+ * set being tested for is built from the explicit tags only. Set operations are plain loops over 64 bit words without
+ * early outs, so they stay branch free and the compiler can vectorize them.
+ */
+struct KAOSGASUTILITIES_API FKaosGameplayTagBitSet
+{
+	using FWord = uint64;
+	static constexpr int32 BitsPerWord = 64;
+
+	/** Dense index for a tag, its replication net index. INDEX_NONE if the tag has none. */
+	static int32 GetTagIndex(const FGameplayTag& Tag);
+
+	/** Builds a bitset from the container's explicit tags, bExpandParents sets the bits of all of their parents as well */
+	static FKaosGameplayTagBitSet FromContainer(const FGameplayTagContainer& Container, bool bExpandParents = false);
+
+	void AddTag(const FGameplayTag& Tag);
+	void RemoveTag(const FGameplayTag& Tag);
+	bool HasTag(const FGameplayTag& Tag) const;
+
+	void AddTagIndex(int32 TagIndex);
+	void RemoveTagIndex(int32 TagIndex);
+	bool HasTagIndex(int32 TagIndex) const;
+
+	/** Returns true if the bit of any of the container's explicit tags is set */
+	bool HasAnyTags(const FGameplayTagContainer& Container) const;
+
+	/** Returns true if the bits of all the container's explicit tags are set. An empty container is always matched. */
+	bool HasAllTags(const FGameplayTagContainer& Container) const;
+
+	/** Sets every bit set in Other (OR) */
+	void Append(const FKaosGameplayTagBitSet& Other) { AppendWords(Other.Words); }
+	void AppendWords(TConstArrayView<FWord> OtherWords);
+
+	/** Clears every bit set in Other (AND NOT) */
+	void Remove(const FKaosGameplayTagBitSet& Other);
+
+	/** Returns true if any bit is set in both (AND) */
+	bool HasAny(const FKaosGameplayTagBitSet& Other) const { return WordsHaveAny(Words, Other.Words); }
+
+	/** Returns true if every bit set in Other is set here (Other AND NOT this is empty). An empty Other is always matched. */
+	bool HasAll(const FKaosGameplayTagBitSet& Other) const { return WordsHaveAll(Words, Other.Words); }
+
+	bool IsEmpty() const;
+	void Reset() { Words.Reset(); }
+
+	/** Adds the tag of every set bit to OutContainer, for handing the set back to containers and Blueprint */
+	void AppendToContainer(FGameplayTagContainer& OutContainer) const;
+	FGameplayTagContainer ToContainer() const;
+
+	bool operator==(const FKaosGameplayTagBitSet& Other) const;
+	bool operator!=(const FKaosGameplayTagBitSet& Other) const { return !(*this == Other); }
+
+	TConstArrayView<FWord> GetWords() const { return Words; }
+
+	/** Word wise kernels, shared with bitsets stored outside of this type such as baked relationship data */
+	static bool WordsHaveTagIndex(TConstArrayView<FWord> InWords, int32 TagIndex);
+	static bool WordsHaveAny(TConstArrayView<FWord> InWords, TConstArrayView<FWord> OtherWords);
+	static bool WordsHaveAll(TConstArrayView<FWord> InWords, TConstArrayView<FWord> OtherWords);
+
+private:
+	/** Words past the end are zero, sets are only grown as high bits are added */
+	TArray<FWord, TInlineAllocator<4>> Words;
+};
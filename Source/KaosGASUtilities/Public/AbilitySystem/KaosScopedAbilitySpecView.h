@@ -0,0 +1,58 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystemComponent.h"
+#include "GameplayAbilitySpec.h"
+
+/**
+ * View over an ability system component's live activatable ability specs, without copying them.
+ *
+ * Holds the ability list lock for its lifetime, so abilities cleared while iterating (for example by a CanActivate or
+ * cancel call) are only removed once the view goes out of scope. Pointers to specs taken from the view point into the
+ * component's own list, and stay valid after the view is gone until that list is next modified, the same as
+ * UAbilitySystemComponent::FindAbilitySpecFromHandle.
+ */
+struct FKaosScopedAbilitySpecView
+{
+	UE_NONCOPYABLE(FKaosScopedAbilitySpecView);
+
+	explicit FKaosScopedAbilitySpecView(UAbilitySystemComponent& AbilitySystemComponent)
+		: AbilityListLock(AbilitySystemComponent)
+		, Specs(AbilitySystemComponent.GetActivatableAbilities())
+	{
+	}
+
+	int32 Num() const { return Specs.Num(); }
+
+	FGameplayAbilitySpec& operator[](int32 Index) { return Specs[Index]; }
+	const FGameplayAbilitySpec& operator[](int32 Index) const { return Specs[Index]; }
+
+	auto begin() { return Specs.begin(); }
+	auto end() { return Specs.end(); }
+	auto begin() const { return Specs.begin(); }
+	auto end() const { return Specs.end(); }
+
+private:
+	FScopedAbilityListLock AbilityListLock;
+	TArray<FGameplayAbilitySpec>& Specs;
+};
@@ -33,6 +33,20 @@ class UKaosGameplayAbilitySet;
 class UGameplayAbility;
 class UAbilitySystemComponent;
 
+/** Question asked of every ability system component in a batched ability query */
+UENUM(BlueprintType)
+enum class EKaosAbilityBatchQuery : uint8
+{
+	/** The first ability with all the tags can be activated */
+	CanActivate,
+	/** An ability with all the tags is granted */
+	HasAbility,
+	/** An ability with all the tags is active */
+	IsActive,
+	/** An ability with all the tags is on cooldown */
+	IsOnCooldown,
+};
+
 /**
  * Collection of helper functions for Gameplay Ability System.
  */
@@ -116,7 +130,21 @@ public:
 	 * Returns true if we can apply attribute modifies for a specific Effect Spec.
 	 */
 	UFUNCTION(BlueprintCallable, Category="KaosGAS")
-	static bool CanApplyAttributeModifiers(UAbilitySystemComponent* AbilitySystemComponent, FGameplayEffectSpec EffectSpec);
+	static bool CanApplyAttributeModifiers(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayEffectSpec& EffectSpec);
+
+	/**
+	 * Asks the same ability question of many actors, for example which squad members can activate Ability.Heal.
+	 * OutMatchingActors receives the actors the query passed for, in input order. Actors without an ASC never match.
+	 */
+	UFUNCTION(BlueprintCallable, Category="KaosGAS")
+	static void BatchQueryAbilitiesForActors(const TArray<AActor*>& Actors, const FGameplayTagContainer& GameplayAbilityTags, EKaosAbilityBatchQuery Query, TArray<AActor*>& OutMatchingActors);
+
+	/**
+	 * Asks the same ability question of many ability system components.
+	 * OutMatchingAbilitySystemComponents receives the components the query passed for, in input order.
+	 */
+	UFUNCTION(BlueprintCallable, Category="KaosGAS")
+	static void BatchQueryAbilities(const TArray<UAbilitySystemComponent*>& AbilitySystemComponents, const FGameplayTagContainer& GameplayAbilityTags, EKaosAbilityBatchQuery Query, TArray<UAbilitySystemComponent*>& OutMatchingAbilitySystemComponents);
 
 	/**
 	 * Will block abilities with the supplied tags
@@ -180,6 +208,7 @@ public:
 
 	/*
 	 * Find's an ability spec for a specific class with OptionalSourceObject
+	 * The returned spec lives in the ASC's ability list and is valid until that list is next modified.
 	 */
 	static FGameplayAbilitySpec* FindAbilitySpecByClass(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UGameplayAbility> AbilityClass, UObject* OptionalSourceObject = nullptr);
 
@@ -187,6 +216,14 @@ public:
 	 * Find's an ability spec for an ability with all tags with OptionalSourceObject
 	 * Example: Ability has tags: A.1 and B.1, and GameplayAbilityTags has A.1, it will return true. But if GameplayAbilityTags
 	 * has A.1 and C.1, it will return false.
+	 * The returned spec lives in the ASC's ability list and is valid until that list is next modified.
 	 */
 	static FGameplayAbilitySpec* FindAbilitySpecWithAllAbilityTags(UAbilitySystemComponent* AbilitySystemComponent, FGameplayTagContainer GameplayAbilityTags, UObject* OptionalSourceObject = nullptr);
+
+	/*
+	 * Batched ability query, returns one bit per component set if the query passed for it. Null components never pass.
+	 * Kaos ASCs answer from their spec indexes. The tag container is resolved once for the whole batch, to the hashes of
+	 * the spec index posting lists and a tag bitset, and every Kaos ASC answers from that.
+	 */
+	static TBitArray<> BatchQueryAbilityMask(TConstArrayView<UAbilitySystemComponent*> AbilitySystemComponents, const FGameplayTagContainer& GameplayAbilityTags, EKaosAbilityBatchQuery Query);
 };
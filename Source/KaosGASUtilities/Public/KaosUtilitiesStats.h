@@ -0,0 +1,107 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** Kaos GAS stats and trace scopes are compiled out of shipping builds */
+#define KAOS_GAS_STATS !UE_BUILD_SHIPPING
+
+DECLARE_STATS_GROUP(TEXT("KaosGAS"), STATGROUP_KaosGAS, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spec Queries"), STAT_KaosGAS_SpecQuery, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CanActivate Checks"), STAT_KaosGAS_CanActivate, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tag Relationship Expansion"), STAT_KaosGAS_TagRelationships, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attribute Init"), STAT_KaosGAS_AttributeInit, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ability Set Give"), STAT_KaosGAS_AbilitySetGive, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ability Set Remove"), STAT_KaosGAS_AbilitySetRemove, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gameplay Cue Helpers"), STAT_KaosGAS_GameplayCue, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Behaviour Tree Nodes"), STAT_KaosGAS_BTNode, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Spec Queries"), STAT_KaosGAS_NumSpecQuery, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num CanActivate Checks"), STAT_KaosGAS_NumCanActivate, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Tag Relationship Expansions"), STAT_KaosGAS_NumTagRelationships, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Attribute Inits"), STAT_KaosGAS_NumAttributeInit, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Ability Set Gives"), STAT_KaosGAS_NumAbilitySetGive, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Ability Set Removes"), STAT_KaosGAS_NumAbilitySetRemove, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Gameplay Cue Helpers"), STAT_KaosGAS_NumGameplayCue, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Num Behaviour Tree Nodes"), STAT_KaosGAS_NumBTNode, STATGROUP_KaosGAS, KAOSGASUTILITIES_API);
+
+#if KAOS_GAS_STATS
+
+UE_TRACE_CHANNEL_EXTERN(KaosGASChannel, KAOSGASUTILITIES_API);
+
+/** AbilitySystem.Kaos.Stats, turns the Kaos GAS stat timers and counters on and off */
+extern KAOSGASUTILITIES_API bool GKaosGASStatsEnabled;
+
+/** The Kaos GAS scope categories, one per STAT_KaosGAS_<Name> pair */
+enum class EKaosGASScope : uint8
+{
+	SpecQuery,
+	CanActivate,
+	TagRelationships,
+	AttributeInit,
+	AbilitySetGive,
+	AbilitySetRemove,
+	GameplayCue,
+	BTNode,
+	Num
+};
+
+/**
+ * Tracks how deep the calling thread is in each Kaos GAS scope category, so a query that calls another query of the
+ * same category (a library wrapper calling the ASC, or one ASC lookup calling another) is timed and counted once.
+ */
+class KAOSGASUTILITIES_API FKaosGASScopeDepth
+{
+public:
+	explicit FKaosGASScopeDepth(EKaosGASScope InScope);
+	~FKaosGASScopeDepth();
+
+	/** True when stats are enabled and this is the first scope of its category on the thread */
+	bool IsOutermost() const { return bOutermost; }
+
+private:
+	EKaosGASScope Scope;
+	bool bEntered;
+	bool bOutermost;
+};
+
+/**
+ * Times the enclosing scope under STAT_KaosGAS_<Name> and bumps the per frame STAT_KaosGAS_Num<Name> counter, only at
+ * the outermost scope of that category on the thread. Also emits a trace scope on the KaosGAS channel at every depth,
+ * so nested queries show up as children in Insights. The trace scope is gated by the KaosGAS trace channel
+ * (-trace=KaosGAS or Trace.Enable KaosGAS), not by AbilitySystem.Kaos.Stats. Use at most once per scope.
+ */
+#define KAOS_GAS_SCOPE(Name) \
+	const FKaosGASScopeDepth KaosGASScopeDepth_##Name(EKaosGASScope::Name); \
+	CONDITIONAL_SCOPE_CYCLE_COUNTER(STAT_KaosGAS_##Name, KaosGASScopeDepth_##Name.IsOutermost()); \
+	if (KaosGASScopeDepth_##Name.IsOutermost()) { INC_DWORD_STAT(STAT_KaosGAS_Num##Name); } \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("KaosGAS::" #Name, KaosGASChannel)
+
+#else
+
+#define KAOS_GAS_SCOPE(Name)
+
+#endif
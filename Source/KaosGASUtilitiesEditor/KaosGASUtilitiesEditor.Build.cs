@@ -51,7 +51,9 @@ public class KaosGASUtilitiesEditor : ModuleRules
                 "GameplayTags",
                 "ToolMenus",
                 "AssetDefinition",
-                "GameplayTagsEditor", "KaosGASUtilities"
+                "GameplayTagsEditor", "KaosGASUtilities",
+                "Json",
+                "Projects"
             }
         );
     }
@@ -0,0 +1,433 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "KaosAbilityBenchmarkCommandlet.h"
+
+#include "AbilitySystem/KaosAbilitySystemComponent.h"
+#include "AbilitySystem/KaosUtilitiesBlueprintLibrary.h"
+#include "AttributeSet.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NativeGameplayTags.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogKaosAbilityBenchmark, Log, All);
+
+namespace KaosAbilityBenchmark_Impl
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Ability, "KaosBenchmark.Ability");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Attack, "KaosBenchmark.Ability.Attack");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Attack_Melee, "KaosBenchmark.Ability.Attack.Melee");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Attack_Melee_Light, "KaosBenchmark.Ability.Attack.Melee.Light");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Attack_Melee_Heavy, "KaosBenchmark.Ability.Attack.Melee.Heavy");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Attack_Ranged_Bow, "KaosBenchmark.Ability.Attack.Ranged.Bow");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Attack_Ranged_Thrown, "KaosBenchmark.Ability.Attack.Ranged.Thrown");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Defend_Block, "KaosBenchmark.Ability.Defend.Block");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Defend_Parry, "KaosBenchmark.Ability.Defend.Parry");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Move_Dash, "KaosBenchmark.Ability.Move.Dash");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Move_Jump_Double, "KaosBenchmark.Ability.Move.Jump.Double");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Utility_Heal, "KaosBenchmark.Ability.Utility.Heal");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Utility_Buff_Haste, "KaosBenchmark.Ability.Utility.Buff.Haste");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Missing, "KaosBenchmark.Ability.Missing");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Cooldown_Short, "KaosBenchmark.Cooldown.Short");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark_Cooldown_Long, "KaosBenchmark.Cooldown.Long");
+
+	/** Number of distinct source objects the synthetic specs are spread over */
+	static constexpr int32 NumSourceObjects = 8;
+
+	/** Every Nth granted ability is put on a timestamp cooldown */
+	static constexpr int32 CooldownStride = 4;
+
+	/** Every Nth granted ability is a UKaosBenchmarkAlternateGameplayAbility */
+	static constexpr int32 AlternateClassStride = 3;
+
+	/** Number of attribute sets spawned on each component, alternating between the benchmark set classes */
+	static constexpr int32 NumAttributeSets = 4;
+
+	static TArray<FGameplayTag> GetLeafTags()
+	{
+		return {
+			TAG_Benchmark_Attack_Melee_Light,
+			TAG_Benchmark_Attack_Melee_Heavy,
+			TAG_Benchmark_Attack_Ranged_Bow,
+			TAG_Benchmark_Attack_Ranged_Thrown,
+			TAG_Benchmark_Defend_Block,
+			TAG_Benchmark_Defend_Parry,
+			TAG_Benchmark_Move_Dash,
+			TAG_Benchmark_Move_Jump_Double,
+			TAG_Benchmark_Utility_Heal,
+			TAG_Benchmark_Utility_Buff_Haste,
+		};
+	}
+
+	/** Times Iterations calls of Func and records the average cost and number of true results on OutQueries */
+	template<typename FuncType>
+	void TimeQuery(TArray<TSharedPtr<FJsonValue>>& OutQueries, const TCHAR* Name, int32 Iterations, FuncType&& Func)
+	{
+		int32 NumHits = 0;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			NumHits += Func(Iteration) ? 1 : 0;
+		}
+		const double ElapsedMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		TSharedRef<FJsonObject> Query = MakeShared<FJsonObject>();
+		Query->SetStringField(TEXT("name"), Name);
+		Query->SetNumberField(TEXT("total_ms"), ElapsedMs);
+		Query->SetNumberField(TEXT("ns_per_call"), Iterations > 0 ? ElapsedMs * 1000000.0 / Iterations : 0.0);
+		Query->SetNumberField(TEXT("hits"), NumHits);
+		OutQueries.Add(MakeShared<FJsonValueObject>(Query));
+
+		UE_LOG(LogKaosAbilityBenchmark, Display, TEXT("  %-56s %10.1f ns/call (%d hits)"), Name, Iterations > 0 ? ElapsedMs * 1000000.0 / Iterations : 0.0, NumHits);
+	}
+}
+
+UKaosBenchmarkGameplayAbility::UKaosBenchmarkGameplayAbility()
+{
+	// Non instanced so the spec uses this object directly and keeps its per object tags
+	InstancingPolicy = EGameplayAbilityInstancingPolicy::NonInstanced;
+	CooldownMode = EKaosAbilityCooldownMode::Timestamp;
+}
+
+void UKaosBenchmarkGameplayAbility::SetBenchmarkTags(const FGameplayTagContainer& InAbilityTags, const FGameplayTagContainer& InCooldownTags)
+{
+	AbilityTags = InAbilityTags;
+	TimestampCooldownTags = InCooldownTags;
+}
+
+UKaosAbilityBenchmarkCommandlet::UKaosAbilityBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UKaosAbilityBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<int32> AbilityCounts = { 10, 100, 1000 };
+	FString AbilityCountsParam;
+	if (FParse::Value(*Params, TEXT("AbilityCounts="), AbilityCountsParam))
+	{
+		TArray<FString> Counts;
+		AbilityCountsParam.ParseIntoArray(Counts, TEXT(","));
+		AbilityCounts.Reset();
+		for (const FString& Count : Counts)
+		{
+			AbilityCounts.Add(FMath::Max(1, FCString::Atoi(*Count)));
+		}
+	}
+
+	int32 Iterations = 10000;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(1, Iterations);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("KaosAbilityBenchmark.json");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("KaosAbilityBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	for (int32 SourceIndex = 0; SourceIndex < KaosAbilityBenchmark_Impl::NumSourceObjects; ++SourceIndex)
+	{
+		SourceObjects.Add(NewObject<UObject>(GetTransientPackage(), UObject::StaticClass(), NAME_None, RF_Transient));
+	}
+	UnusedSourceObject = NewObject<UObject>(GetTransientPackage(), UObject::StaticClass(), NAME_None, RF_Transient);
+
+	TArray<TSharedPtr<FJsonValue>> Runs;
+	for (const int32 NumAbilities : AbilityCounts)
+	{
+		UE_LOG(LogKaosAbilityBenchmark, Display, TEXT("Benchmarking %d granted abilities, %d iterations per query"), NumAbilities, Iterations);
+
+		AActor* OwnerActor = World->SpawnActor<AActor>();
+		UKaosAbilitySystemComponent* AbilitySystemComponent = NewObject<UKaosAbilitySystemComponent>(OwnerActor);
+		AbilitySystemComponent->RegisterComponent();
+		AbilitySystemComponent->InitAbilityActorInfo(OwnerActor, OwnerActor);
+		AddSyntheticAttributeSets(AbilitySystemComponent);
+
+		TArray<FGameplayAbilitySpecHandle> Handles;
+		GrantSyntheticAbilities(AbilitySystemComponent, NumAbilities, Handles);
+
+		TSharedRef<FJsonObject> Run = RunQueries(AbilitySystemComponent, Handles, Iterations);
+		Run->SetNumberField(TEXT("num_abilities"), NumAbilities);
+		Runs.Add(MakeShared<FJsonValueObject>(Run));
+
+		AbilitySystemComponent->ClearAllAbilities();
+		OwnerActor->Destroy();
+	}
+
+	SourceObjects.Reset();
+	UnusedSourceObject = nullptr;
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("KaosGASUtilities"));
+	Root->SetStringField(TEXT("plugin_version"), Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString());
+	Root->SetStringField(TEXT("engine_version"), FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	Root->SetNumberField(TEXT("iterations"), Iterations);
+	Root->SetArrayField(TEXT("runs"), Runs);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+
+	if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogKaosAbilityBenchmark, Error, TEXT("Failed to write benchmark results to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogKaosAbilityBenchmark, Display, TEXT("Wrote benchmark results to %s"), *OutputPath);
+	return 0;
+}
+
+void UKaosAbilityBenchmarkCommandlet::AddSyntheticAttributeSets(UKaosAbilitySystemComponent* AbilitySystemComponent) const
+{
+	using namespace KaosAbilityBenchmark_Impl;
+
+	const TSubclassOf<UAttributeSet> SetClasses[] = { UKaosBenchmarkAttributeSet::StaticClass(), UKaosBenchmarkSecondaryAttributeSet::StaticClass() };
+	for (int32 SetIndex = 0; SetIndex < NumAttributeSets; ++SetIndex)
+	{
+		const TSubclassOf<UAttributeSet> SetClass = SetClasses[SetIndex % UE_ARRAY_COUNT(SetClasses)];
+		AbilitySystemComponent->AddAttributeSet(NewObject<UAttributeSet>(AbilitySystemComponent->GetOwner(), SetClass, NAME_None, RF_Transient));
+	}
+}
+
+void UKaosAbilityBenchmarkCommandlet::GrantSyntheticAbilities(UKaosAbilitySystemComponent* AbilitySystemComponent, int32 NumAbilities, TArray<FGameplayAbilitySpecHandle>& OutHandles)
+{
+	using namespace KaosAbilityBenchmark_Impl;
+
+	const TArray<FGameplayTag> LeafTags = GetLeafTags();
+	OutHandles.Reserve(NumAbilities);
+
+	for (int32 AbilityIndex = 0; AbilityIndex < NumAbilities; ++AbilityIndex)
+	{
+		// Spread the abilities over leaves of different depths, with every third ability carrying a second tag
+		FGameplayTagContainer AbilityTags(LeafTags[AbilityIndex % LeafTags.Num()]);
+		if (AbilityIndex % 3 == 0)
+		{
+			AbilityTags.AddTag(LeafTags[(AbilityIndex * 7 + 3) % LeafTags.Num()]);
+		}
+
+		const FGameplayTagContainer CooldownTags(AbilityIndex % 2 == 0 ? TAG_Benchmark_Cooldown_Short : TAG_Benchmark_Cooldown_Long);
+
+		UClass* AbilityClass = AbilityIndex % AlternateClassStride == 1 ? UKaosBenchmarkAlternateGameplayAbility::StaticClass() : UKaosBenchmarkGameplayAbility::StaticClass();
+		UKaosBenchmarkGameplayAbility* Ability = NewObject<UKaosBenchmarkGameplayAbility>(GetTransientPackage(), AbilityClass, NAME_None, RF_Transient);
+		Ability->SetBenchmarkTags(AbilityTags, CooldownTags);
+
+		FGameplayAbilitySpec Spec(Ability, 1, INDEX_NONE, SourceObjects[AbilityIndex % SourceObjects.Num()]);
+		OutHandles.Add(AbilitySystemComponent->GiveAbility(Spec));
+	}
+
+	for (int32 AbilityIndex = 0; AbilityIndex < OutHandles.Num(); AbilityIndex += CooldownStride)
+	{
+		AbilitySystemComponent->StartTimestampCooldown(OutHandles[AbilityIndex], 3600.0f);
+	}
+}
+
+TSharedRef<FJsonObject> UKaosAbilityBenchmarkCommandlet::RunQueries(UKaosAbilitySystemComponent* AbilitySystemComponent, const TArray<FGameplayAbilitySpecHandle>& Handles, int32 Iterations) const
+{
+	using namespace KaosAbilityBenchmark_Impl;
+
+	// Query inputs cycle through hits on leaves and parents, multi tag containers and misses
+	TArray<FGameplayTagContainer> TagQueries;
+	for (const FGameplayTag& LeafTag : GetLeafTags())
+	{
+		TagQueries.Add(FGameplayTagContainer(LeafTag));
+	}
+	TagQueries.Add(FGameplayTagContainer(TAG_Benchmark_Attack));
+	TagQueries.Add(FGameplayTagContainer(TAG_Benchmark_Attack_Melee));
+	TagQueries.Add(FGameplayTagContainer::CreateFromArray(TArray<FGameplayTag>{ TAG_Benchmark_Attack_Melee_Light, TAG_Benchmark_Move_Jump_Double }));
+	TagQueries.Add(FGameplayTagContainer(TAG_Benchmark_Missing));
+
+	const TArray<FGameplayTag> SingleTags = { TAG_Benchmark_Ability, TAG_Benchmark_Attack_Melee_Heavy, TAG_Benchmark_Utility_Buff_Haste, TAG_Benchmark_Missing };
+
+	// Every handle query is checked against granted handles and one invalid handle
+	TArray<FGameplayAbilitySpecHandle> HandleQueries = Handles;
+	HandleQueries.Add(FGameplayAbilitySpecHandle());
+
+	// Class queries alternate between the two granted classes and one that was never granted
+	const TArray<TSubclassOf<UGameplayAbility>> ClassQueries = { UKaosBenchmarkGameplayAbility::StaticClass(), UKaosBenchmarkAlternateGameplayAbility::StaticClass(), UKaosGameplayAbility::StaticClass() };
+
+	// Source queries include one no spec was granted from, which misses after the class posting list is found
+	TArray<UObject*> SourceQueries(SourceObjects);
+	SourceQueries.Add(UnusedSourceObject);
+
+	// Attribute set queries hit on both spawned classes and on their parent, and miss on a class that was never spawned
+	const TArray<TSubclassOf<UAttributeSet>> AttributeSetQueries = { UKaosBenchmarkAttributeSet::StaticClass(), UKaosBenchmarkSecondaryAttributeSet::StaticClass(), UAttributeSet::StaticClass(), UKaosBenchmarkUnusedAttributeSet::StaticClass() };
+
+	auto TagQuery = [&TagQueries](int32 Iteration) -> const FGameplayTagContainer& { return TagQueries[Iteration % TagQueries.Num()]; };
+	auto HandleQuery = [&HandleQueries](int32 Iteration) -> const FGameplayAbilitySpecHandle& { return HandleQueries[Iteration % HandleQueries.Num()]; };
+	auto ClassQuery = [&ClassQueries](int32 Iteration) { return ClassQueries[Iteration % ClassQueries.Num()]; };
+	auto SourceQuery = [&SourceQueries](int32 Iteration) { return SourceQueries[Iteration % SourceQueries.Num()]; };
+	auto AttributeSetQuery = [&AttributeSetQueries](int32 Iteration) { return AttributeSetQueries[Iteration % AttributeSetQueries.Num()]; };
+
+	TArray<TSharedPtr<FJsonValue>> Queries;
+
+	// UKaosAbilitySystemComponent
+	TimeQuery(Queries, TEXT("ASC.CanActivateAbilityByClass"), Iterations, [&](int32 Iteration)
+	{
+		FGameplayTagContainer FailureTags;
+		return AbilitySystemComponent->CanActivateAbilityByClass(ClassQuery(Iteration), FailureTags);
+	});
+	TimeQuery(Queries, TEXT("ASC.CanActivateAbilityByHandle"), Iterations, [&](int32 Iteration)
+	{
+		FGameplayTagContainer FailureTags;
+		return AbilitySystemComponent->CanActivateAbilityByHandle(HandleQuery(Iteration), FailureTags);
+	});
+	TimeQuery(Queries, TEXT("ASC.IsAbilityActive"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsAbilityActive(HandleQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.IsAbilityActiveByClass"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsAbilityActiveByClass(ClassQuery(Iteration), SourceQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.IsAbilityActiveByTags"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsAbilityActiveByTags(&TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.HasActiveAbilityWithAnyMatchingTag"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->HasActiveAbilityWithAnyMatchingTag(TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.HasActiveAbilityWithAllMatchingTag"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->HasActiveAbilityWithAllMatchingTag(TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.CanActivateAbilityWithAnyMatchingTag"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->CanActivateAbilityWithAnyMatchingTag(TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.CanActivateAbilityWithAllMatchingTag"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->CanActivateAbilityWithAllMatchingTag(TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.CanActivateAbilityWithAllMatchingTags"), Iterations, [&](int32 Iteration)
+	{
+		FGameplayTagContainer FailureTags;
+		return AbilitySystemComponent->CanActivateAbilityWithAllMatchingTags(TagQuery(Iteration), FailureTags);
+	});
+	TimeQuery(Queries, TEXT("ASC.CanActivateAbilities"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->CanActivateAbilities(TagQueries).CanActivate(Iteration % TagQueries.Num());
+	});
+	TimeQuery(Queries, TEXT("ASC.HasAbilityWithAllTags"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->HasAbilityWithAllTags(TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.IsAbilityOnCooldownWithAllTags"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsAbilityOnCooldownWithAllTags(TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.IsAbilityOnCooldown"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsAbilityOnCooldown(HandleQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.IsTimestampCooldownActive"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsTimestampCooldownActive(HandleQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.GetTimestampCooldownTimeRemaining"), Iterations, [&](int32 Iteration)
+	{
+		float TimeRemaining = 0.0f;
+		float Duration = 0.0f;
+		return AbilitySystemComponent->GetTimestampCooldownTimeRemaining(HandleQuery(Iteration), TimeRemaining, Duration);
+	});
+	TimeQuery(Queries, TEXT("ASC.IsAbilityTagBlocked"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->IsAbilityTagBlocked(SingleTags[Iteration % SingleTags.Num()]);
+	});
+	TimeQuery(Queries, TEXT("ASC.HasAttributeSet"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->HasAttributeSet(AttributeSetQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("ASC.FindAbilitySpecFromHandle"), Iterations, [&](int32 Iteration)
+	{
+		return AbilitySystemComponent->FindAbilitySpecFromHandle(HandleQuery(Iteration)) != nullptr;
+	});
+
+	// UKaosUtilitiesBlueprintLibrary
+	TimeQuery(Queries, TEXT("Library.CanActivateAbilityWithMatchingTags"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::CanActivateAbilityWithMatchingTags(AbilitySystemComponent, TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.HasActiveAbilityWithMatchingTags"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::HasActiveAbilityWithMatchingTags(AbilitySystemComponent, TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.HasAbilityWithAllTags"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::HasAbilityWithAllTags(AbilitySystemComponent, TagQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.IsAbilityOnCooldownWithAllTags"), Iterations, [&](int32 Iteration)
+	{
+		float TimeRemaining = 0.0f;
+		float Duration = 0.0f;
+		return UKaosUtilitiesBlueprintLibrary::IsAbilityOnCooldownWithAllTags(AbilitySystemComponent, TagQuery(Iteration), TimeRemaining, Duration);
+	});
+	TimeQuery(Queries, TEXT("Library.CanActivateAbilityByClass"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::CanActivateAbilityByClass(AbilitySystemComponent, ClassQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.IsAbilityActive"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::IsAbilityActive(AbilitySystemComponent, HandleQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.IsAbilityActiveByClass"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::IsAbilityActiveByClass(AbilitySystemComponent, ClassQuery(Iteration), SourceQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.IsAbilityTagBlocked"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::IsAbilityTagBlocked(AbilitySystemComponent, SingleTags[Iteration % SingleTags.Num()]);
+	});
+	TimeQuery(Queries, TEXT("Library.HasAttributeSet"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::HasAttributeSet(AbilitySystemComponent, AttributeSetQuery(Iteration));
+	});
+	TimeQuery(Queries, TEXT("Library.FindAbilitySpecByClass"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::FindAbilitySpecByClass(AbilitySystemComponent, ClassQuery(Iteration), SourceQuery(Iteration)) != nullptr;
+	});
+	TimeQuery(Queries, TEXT("Library.FindAbilitySpecWithAllAbilityTags"), Iterations, [&](int32 Iteration)
+	{
+		return UKaosUtilitiesBlueprintLibrary::FindAbilitySpecWithAllAbilityTags(AbilitySystemComponent, TagQuery(Iteration)) != nullptr;
+	});
+
+	TSharedRef<FJsonObject> Run = MakeShared<FJsonObject>();
+	Run->SetArrayField(TEXT("queries"), Queries);
+	return Run;
+}
@@ -0,0 +1,110 @@
+﻿// Copyright (C) 2024, Daniel Moss
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AbilitySystem/KaosGameplayAbility.h"
+#include "AttributeSet.h"
+#include "Commandlets/Commandlet.h"
+#include "KaosAbilityBenchmarkCommandlet.generated.h"
+
+class FJsonObject;
+class UKaosAbilitySystemComponent;
+
+/**
+ * Non instanced ability granted by the benchmark, so every spec can carry its own tags on the ability object.
+ */
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UKaosBenchmarkGameplayAbility : public UKaosGameplayAbility
+{
+	GENERATED_BODY()
+
+public:
+	UKaosBenchmarkGameplayAbility();
+
+	void SetBenchmarkTags(const FGameplayTagContainer& InAbilityTags, const FGameplayTagContainer& InCooldownTags);
+};
+
+/**
+ * Second ability class granted by the benchmark, so class lookups have more than one class posting list to pick from.
+ */
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UKaosBenchmarkAlternateGameplayAbility : public UKaosBenchmarkGameplayAbility
+{
+	GENERATED_BODY()
+};
+
+/** Attribute sets spawned on the benchmark components, so attribute set lookups run against a populated component */
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UKaosBenchmarkAttributeSet : public UAttributeSet
+{
+	GENERATED_BODY()
+};
+
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UKaosBenchmarkSecondaryAttributeSet : public UAttributeSet
+{
+	GENERATED_BODY()
+};
+
+/** Never spawned, the attribute set lookup miss */
+UCLASS(Transient, HideDropdown, NotBlueprintable)
+class UKaosBenchmarkUnusedAttributeSet : public UAttributeSet
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Times the ability lookup hot paths of UKaosAbilitySystemComponent and UKaosUtilitiesBlueprintLibrary against
+ * components with a synthetic set of granted abilities, and writes the results as JSON.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=KaosAbilityBenchmark -nullrhi [-AbilityCounts=10,100,1000] [-Iterations=10000] [-Output=<File.json>]
+ */
+UCLASS()
+class UKaosAbilityBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UKaosAbilityBenchmarkCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+
+protected:
+	/** Spawns a few synthetic attribute sets of more than one class on the component */
+	void AddSyntheticAttributeSets(UKaosAbilitySystemComponent* AbilitySystemComponent) const;
+
+	/** Grants NumAbilities synthetic abilities, of more than one class, to the component and returns their handles */
+	void GrantSyntheticAbilities(UKaosAbilitySystemComponent* AbilitySystemComponent, int32 NumAbilities, TArray<FGameplayAbilitySpecHandle>& OutHandles);
+
+	/** Runs every query against the component and returns the timings for this ability count */
+	TSharedRef<FJsonObject> RunQueries(UKaosAbilitySystemComponent* AbilitySystemComponent, const TArray<FGameplayAbilitySpecHandle>& Handles, int32 Iterations) const;
+
+	/** Source objects shared between the synthetic specs, so class and source lookups see more than one source */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UObject>> SourceObjects;
+
+	/** Source object no spec is granted from, the class and source lookup miss inside a populated class posting list */
+	UPROPERTY(Transient)
+	TObjectPtr<UObject> UnusedSourceObject;
+};